@@ -0,0 +1,230 @@
+#ifndef _DE_BSWALZ_FLATSET_H
+#define _DE_BSWALZ_FLATSET_H
+
+/**
+ * Template class which implements a sorted set in contiguous storage
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common
+ */
+/*
+ * This file is part of common package
+ *
+ * common is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace de { namespace bswalz {
+
+/**
+ * Template class flat_set, a sorted set of unique elements in contiguous storage.<br>
+ * Up to N elements are stored inline without any heap allocation. Lookup and
+ * removal are O(log n), iteration is a linear walk over an array.<br>
+ * The type T is either atomic data or is class data that has the following
+ * member functions:<br>
+ *   T::T ()
+ *   T& T::operator= (const T&)
+ *   bool T::operator< (const T&) const
+ */
+template <class T, size_t N = 4>
+class flat_set {
+	static_assert(N > 0, "de::bswalz::flat_set requires an inline capacity of at least 1");
+public:
+	typedef const T* const_iterator;
+
+	/** Constructs an empty set */
+	flat_set ();
+	/** Copy constructor */
+	flat_set (const flat_set& r);
+	/** Move constructor */
+	flat_set (flat_set&& r);
+	/** Assignment operator */
+	flat_set& operator= (const flat_set& r);
+	/** Move assignment operator */
+	flat_set& operator= (flat_set&& r);
+
+	/** Destructor */
+	~flat_set ();
+
+	/** @return the amount of elements of this set */
+	size_t   size () const { return m_Size; }
+
+	/** @return true if the set is empty */
+	bool     empty () const { return m_Size == 0; }
+
+	/** @return an iterator to the first (smallest) element */
+	const_iterator begin () const { return m_pData; }
+
+	/** @return an iterator behind the last element */
+	const_iterator end () const { return m_pData + m_Size; }
+
+	/**
+	 * Inserts an element, if not yet present.
+	 * @return true if the element has been inserted
+	 */
+	bool     insert (const T& value);
+
+	/**
+	 * Removes an element.
+	 * @return the number of removed elements (0 or 1)
+	 */
+	size_t   erase (const T& value);
+
+	/** @return the position of the element or end() if not found */
+	const_iterator find (const T& value) const;
+
+	/** @return the number of elements equal to value (0 or 1) */
+	size_t   count (const T& value) const { return (find(value) != end()) ? 1 : 0; }
+
+	/** Ensures the capacity for at least n elements */
+	void     reserve (size_t n);
+
+	/** Empties the set. The size ist 0 afterwards. */
+	void     clear () { m_Size = 0; }
+
+private:
+	T *      m_pData;
+	size_t   m_Size;
+	size_t   m_Capacity;
+	T        m_Inline[N];
+
+	bool     isInline () const { return m_pData == m_Inline; }
+	void     assign (const flat_set& r);
+	void     steal (flat_set& r);
+};
+
+
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+flat_set<T,N>::flat_set () : m_pData(m_Inline), m_Size(0), m_Capacity(N) {
+	// Intentionally left blank
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+flat_set<T,N>::flat_set (const flat_set& r) : m_pData(m_Inline), m_Size(0), m_Capacity(N) {
+	assign(r);
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+flat_set<T,N>::flat_set (flat_set&& r) : m_pData(m_Inline), m_Size(0), m_Capacity(N) {
+	steal(r);
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+flat_set<T,N>& flat_set<T,N>::operator= (const flat_set& r) {
+	if (this != &r)
+		assign(r);
+	return *this;
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+flat_set<T,N>& flat_set<T,N>::operator= (flat_set&& r) {
+	if (this != &r) {
+		if (!isInline())
+			delete [] m_pData;
+		m_pData    = m_Inline;
+		m_Size     = 0;
+		m_Capacity = N;
+		steal(r);
+		}
+	return *this;
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+flat_set<T,N>::~flat_set () {
+	if (!isInline())
+		delete [] m_pData;
+}
+
+//----------------------------------------------------------------------------
+// Copies the elements of r, the capacity is increased if necessary
+template <class T, size_t N> inline
+void flat_set<T,N>::assign (const flat_set& r) {
+	m_Size = 0;
+	reserve(r.m_Size);
+	std::copy(r.m_pData, r.m_pData + r.m_Size, m_pData);
+	m_Size = r.m_Size;
+}
+//----------------------------------------------------------------------------
+// Takes over the heap storage of r, inline elements are moved
+template <class T, size_t N> inline
+void flat_set<T,N>::steal (flat_set& r) {
+	if (r.isInline()) {
+		std::move(r.m_pData, r.m_pData + r.m_Size, m_pData);
+		m_Size = r.m_Size;
+		}
+	else {
+		m_pData      = r.m_pData;
+		m_Size       = r.m_Size;
+		m_Capacity   = r.m_Capacity;
+		r.m_pData    = r.m_Inline;
+		r.m_Capacity = N;
+		}
+	r.m_Size = 0;
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+void flat_set<T,N>::reserve (size_t n) {
+	if (n <= m_Capacity) return;
+
+	T * pData = new T[n];
+	std::move(m_pData, m_pData + m_Size, pData);
+	if (!isInline())
+		delete [] m_pData;
+	m_pData    = pData;
+	m_Capacity = n;
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+bool flat_set<T,N>::insert (const T& value) {
+	T * pPos = std::lower_bound(m_pData, m_pData + m_Size, value);
+	if (pPos != m_pData + m_Size && !(value < *pPos))
+		return false; // Already present
+
+	const size_t idx = pPos - m_pData;
+	if (m_Size == m_Capacity)
+		reserve(2 * m_Capacity);
+	pPos = m_pData + idx;
+	std::move_backward(pPos, m_pData + m_Size, m_pData + m_Size + 1);
+	*pPos = value;
+	m_Size++;
+	return true;
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+size_t flat_set<T,N>::erase (const T& value) {
+	T * pPos = const_cast<T *>(find(value));
+	if (pPos == m_pData + m_Size)
+		return 0;
+
+	std::move(pPos + 1, m_pData + m_Size, pPos);
+	m_Size--;
+	return 1;
+}
+//----------------------------------------------------------------------------
+template <class T, size_t N> inline
+typename flat_set<T,N>::const_iterator flat_set<T,N>::find (const T& value) const {
+	const T * pPos = std::lower_bound(begin(), end(), value);
+	return (pPos != end() && !(value < *pPos)) ? pPos : end();
+}
+
+}} // End namespaces
+
+#endif /*_DE_BSWALZ_FLATSET_H*/
@@ -0,0 +1,176 @@
+#ifndef _DE_BSWALZ_INPLACEFUNCTION_H
+#define _DE_BSWALZ_INPLACEFUNCTION_H
+
+/**
+ * Template class which implements a callable wrapper with inline storage
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common
+ */
+/*
+ * This file is part of common package
+ *
+ * common is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace de { namespace bswalz {
+
+template <class Signature, size_t Size = 32> class inplace_function;
+
+/**
+ * Template class inplace_function, a copyable wrapper of a callable like std::function.<br>
+ * The callable is always stored inline within Size bytes, hence construction,
+ * copy and invocation never allocate. Callables exceeding Size are rejected at
+ * compile time. Invocation is an indirect call through a function pointer, no
+ * virtual dispatch is involved.
+ */
+template <class R, class... Args, size_t Size>
+class inplace_function<R(Args...), Size> {
+public:
+	/** Constructs an empty function */
+	inplace_function () : m_pOps(nullptr) {}
+
+	/** Constructs a function from a callable */
+	template <class F, class = typename std::enable_if<
+		!std::is_same<typename std::decay<F>::type, inplace_function>::value>::type>
+	inplace_function (F&& f);
+
+	/** Copy constructor */
+	inplace_function (const inplace_function& r);
+	/** Move constructor */
+	inplace_function (inplace_function&& r);
+	/** Assignment operator */
+	inplace_function& operator= (const inplace_function& r);
+	/** Move assignment operator */
+	inplace_function& operator= (inplace_function&& r);
+
+	/** Destructor */
+	~inplace_function () { reset(); }
+
+	/** @return true if a callable is stored */
+	explicit operator bool () const { return m_pOps != nullptr; }
+
+	/**
+	 * Invokes the stored callable
+	 * @throws std::bad_function_call if the function is empty
+	 */
+	R operator() (Args... args) const {
+		if (m_pOps == nullptr)
+			throw std::bad_function_call();
+		return m_pOps->m_pInvoke(const_cast<void *>(static_cast<const void *>(&m_Storage)), std::forward<Args>(args)...);
+	}
+
+private:
+	// Type erased operations of the stored callable, one static instance per type
+	struct Ops {
+		R    (*m_pInvoke) (void * pF, Args&&... args);
+		void (*m_pCopy)   (void * pDest, const void * pSrc);
+		void (*m_pMove)   (void * pDest, void * pSrc);
+		void (*m_pDestroy)(void * pF);
+	};
+
+	template <class F> struct OpsOf {
+		static R    invoke (void * pF, Args&&... args) { return (*static_cast<F *>(pF))(std::forward<Args>(args)...); }
+		static void copy (void * pDest, const void * pSrc) { new (pDest) F(*static_cast<const F *>(pSrc)); }
+		static void move (void * pDest, void * pSrc) { new (pDest) F(std::move(*static_cast<F *>(pSrc))); }
+		static void destroy (void * pF) { static_cast<F *>(pF)->~F(); }
+		static const Ops ops;
+	};
+
+	void     reset ();
+
+	const Ops * m_pOps;
+	typename std::aligned_storage<Size, alignof(std::max_align_t)>::type m_Storage;
+};
+
+
+//----------------------------------------------------------------------------
+template <class R, class... Args, size_t Size>
+template <class F>
+const typename inplace_function<R(Args...),Size>::Ops inplace_function<R(Args...),Size>::OpsOf<F>::ops = {
+	&OpsOf<F>::invoke, &OpsOf<F>::copy, &OpsOf<F>::move, &OpsOf<F>::destroy };
+
+//----------------------------------------------------------------------------
+template <class R, class... Args, size_t Size>
+template <class F, class> inline
+inplace_function<R(Args...),Size>::inplace_function (F&& f) : m_pOps(nullptr) {
+	typedef typename std::decay<F>::type Callable;
+	static_assert(sizeof(Callable) <= Size, "de::bswalz::inplace_function: callable exceeds the inline storage");
+	static_assert(alignof(Callable) <= alignof(std::max_align_t), "de::bswalz::inplace_function: callable is over-aligned");
+	new (&m_Storage) Callable(std::forward<F>(f));
+	m_pOps = &OpsOf<Callable>::ops;
+}
+//----------------------------------------------------------------------------
+template <class R, class... Args, size_t Size> inline
+inplace_function<R(Args...),Size>::inplace_function (const inplace_function& r) : m_pOps(nullptr) {
+	if (r.m_pOps != nullptr) {
+		r.m_pOps->m_pCopy(&m_Storage, &r.m_Storage);
+		m_pOps = r.m_pOps;
+		}
+}
+//----------------------------------------------------------------------------
+template <class R, class... Args, size_t Size> inline
+inplace_function<R(Args...),Size>::inplace_function (inplace_function&& r) : m_pOps(nullptr) {
+	if (r.m_pOps != nullptr) {
+		r.m_pOps->m_pMove(&m_Storage, &r.m_Storage);
+		m_pOps = r.m_pOps;
+		r.reset();
+		}
+}
+//----------------------------------------------------------------------------
+template <class R, class... Args, size_t Size> inline
+inplace_function<R(Args...),Size>& inplace_function<R(Args...),Size>::operator= (const inplace_function& r) {
+	if (this != &r) {
+		reset();
+		if (r.m_pOps != nullptr) {
+			r.m_pOps->m_pCopy(&m_Storage, &r.m_Storage);
+			m_pOps = r.m_pOps;
+			}
+		}
+	return *this;
+}
+//----------------------------------------------------------------------------
+template <class R, class... Args, size_t Size> inline
+inplace_function<R(Args...),Size>& inplace_function<R(Args...),Size>::operator= (inplace_function&& r) {
+	if (this != &r) {
+		reset();
+		if (r.m_pOps != nullptr) {
+			r.m_pOps->m_pMove(&m_Storage, &r.m_Storage);
+			m_pOps = r.m_pOps;
+			r.reset();
+			}
+		}
+	return *this;
+}
+//----------------------------------------------------------------------------
+template <class R, class... Args, size_t Size> inline
+void inplace_function<R(Args...),Size>::reset () {
+	if (m_pOps != nullptr) {
+		m_pOps->m_pDestroy(&m_Storage);
+		m_pOps = nullptr;
+		}
+}
+
+}} // End namespaces
+
+#endif /*_DE_BSWALZ_INPLACEFUNCTION_H*/
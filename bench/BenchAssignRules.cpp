@@ -0,0 +1,99 @@
+/**
+ * AssignRule benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Rule applications and view updates per assignment of a graph of AssignRules
+ * with fan-out and fan-in: source -> W models -> sink -> W leaves
+ */
+
+#include "../model/Parameter.h"
+#include "../tests/Check.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+static long s_Applications = 0;
+
+// -------------------------------------------------------
+class AddRule : public mvc::TAssignRule<int> {
+public:
+	AddRule(CIntParameter * pTarget, int offset) : m_pTarget(pTarget), m_Offset(offset) { addTarget(pTarget); }
+	virtual void apply(mvc::TModel<int> * pSource) override { s_Applications++; m_pTarget->assignValue(pSource->getValue() + m_Offset, this); }
+	virtual void revert() override { m_pTarget->revertAssignment(); }
+private:
+	CIntParameter * m_pTarget;
+	int             m_Offset;
+};
+
+// -------------------------------------------------------
+int main() {
+	const int width = 10;
+	CIntParameter source("source", 0, -1000000, 1000000), sink("sink", 0, -1000000, 1000000);
+	std::vector<std::unique_ptr<CIntParameter>> mids, leaves;
+	std::vector<std::unique_ptr<AddRule>> rules;
+	std::vector<CountingView> views(2 * width + 2);
+	for (int i = 0; i < width; i++) {
+		mids.emplace_back(new CIntParameter("m" + std::to_string(i), 0, -1000000, 1000000));
+		leaves.emplace_back(new CIntParameter("l" + std::to_string(i), 0, -1000000, 1000000));
+		}
+	for (int i = 0; i < width; i++) {
+		rules.emplace_back(new AddRule(mids[i].get(), i));
+		source.addAssignRule(rules.back().get());
+		rules.emplace_back(new AddRule(&sink, 0));
+		mids[i]->addAssignRule(rules.back().get());
+		rules.emplace_back(new AddRule(leaves[i].get(), 1));
+		sink.addAssignRule(rules.back().get());
+		}
+	views[0].registerAt(&source);
+	views[1].registerAt(&sink);
+	for (int i = 0; i < width; i++) {
+		views[2 + i].registerAt(mids[i].get());
+		views[2 + width + i].registerAt(leaves[i].get());
+		}
+	const int n = 10000;
+	const auto t0 = std::chrono::steady_clock::now();
+	for (int i = 1; i <= n; i++)
+		source.assignValue(i);
+	const auto t1 = std::chrono::steady_clock::now();
+	long updates = 0;
+	for (const CountingView & view : views)
+		updates += view.m_Updates.load();
+	std::printf("per assignment: %.1f rule applications, %.1f view updates, %.2f us; sink=%d leaf0=%d\n",
+		double(s_Applications) / n, double(updates) / n,
+		std::chrono::duration<double, std::micro>(t1 - t0).count() / n, sink.getValue(), leaves[0]->getValue());
+	views[0].unregisterAt(&source);
+	views[1].unregisterAt(&sink);
+	for (int i = 0; i < width; i++) {
+		views[2 + i].unregisterAt(mids[i].get());
+		views[2 + width + i].unregisterAt(leaves[i].get());
+		}
+	return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * Coalescing benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Delivery latency of an asynchronous model depending on the coalescing window
+ */
+
+#include "../mvc/Model.h"
+#include "../mvc/View.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+
+typedef std::chrono::steady_clock Clock;
+
+static std::vector<double> s_Latencies;
+static std::atomic<long>   s_Updates(0);
+
+// -------------------------------------------------------
+class LatencyView : public mvc::View {
+public:
+	virtual void update(const mvc::Model *, void * pObject) override {
+		s_Latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - *static_cast<Clock::time_point *>(pObject)).count());
+		s_Updates++;
+	}
+};
+
+class NotifyingModel : public mvc::Model {
+public:
+	NotifyingModel() : mvc::Model("m") {}
+	void fire(void * pObject) { setChanged(); notifyAll(pObject); }
+};
+
+// -------------------------------------------------------
+int main() {
+	NotifyingModel model;
+	model.setSyncMode(false);
+	LatencyView view;
+	view.registerAt(&model);
+	for (int window : { 0, 1000, 10000 }) {
+		mvc::Model::setCoalescingWindow(std::chrono::microseconds(window));
+		const int samples = window ? 200 : 5000;
+		std::vector<Clock::time_point> stamps(samples);
+		s_Latencies.clear();
+		s_Latencies.reserve(samples);
+		s_Updates = 0;
+		for (int i = 0; i < samples; i++) {
+			stamps[i] = Clock::now();
+			model.fire(&stamps[i]);
+			while (s_Updates <= i)
+				std::this_thread::yield();
+			}
+		std::sort(s_Latencies.begin(), s_Latencies.end());
+		auto percentile = [](double q) { return s_Latencies[size_t(q * (s_Latencies.size() - 1))]; };
+		std::printf("window=%6d us: p50 %8.1f us  p90 %8.1f us  p99 %8.1f us  max %8.1f us\n",
+			window, percentile(0.5), percentile(0.9), percentile(0.99), s_Latencies.back());
+		}
+	view.unregisterAt(&model);
+	return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * Executor benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Delivery of updates to the thread owning the views: views re-marshalling
+ * themselves by a std::function queue versus View::setExecutor()
+ */
+
+#include "../model/Parameter.h"
+#include "../mvc/Executor.h"
+#include "../mvc/View.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+static std::thread::id   s_Owner;
+static std::atomic<long> s_Updates(0);
+static std::atomic<long> s_WrongThread(0);
+
+// -------------------------------------------------------
+// The queue of a view marshalling its updates itself
+class FunctionQueue {
+public:
+	void post(std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Tasks.push_back(std::move(task));
+		}
+		m_Condition.notify_one();
+	}
+	void drain() {
+		std::vector<std::function<void()>> tasks;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait_for(lock, std::chrono::milliseconds(1), [this]() { return !m_Tasks.empty(); });
+			tasks.swap(m_Tasks);
+		}
+		for (auto & task : tasks)
+			task();
+	}
+private:
+	std::mutex                         m_Mutex;
+	std::condition_variable            m_Condition;
+	std::vector<std::function<void()>> m_Tasks;
+};
+
+static FunctionQueue s_FunctionQueue;
+
+static void countUpdate() {
+	if (std::this_thread::get_id() != s_Owner)
+		s_WrongThread++;
+	s_Updates++;
+}
+
+class MarshallingView : public mvc::View {
+public:
+	virtual void update(const mvc::Model *, void *) override { s_FunctionQueue.post(countUpdate); }
+};
+
+class ExecutedView : public mvc::View {
+public:
+	virtual void update(const mvc::Model *, void *) override { countUpdate(); }
+};
+
+// -------------------------------------------------------
+int main() {
+	const int n = 200000, viewCount = 8;
+	for (bool executor : { false, true }) {
+		mvc::ExecutorQueue queue;
+		std::atomic<bool> running(true);
+		s_Updates = 0;
+		s_WrongThread = 0;
+		std::thread owner([&]() {
+			s_Owner = std::this_thread::get_id();
+			while (running || s_Updates < long(n) * viewCount) {
+				if (executor) {
+					queue.wait(std::chrono::milliseconds(1));
+					queue.runPending();
+					}
+				else
+					s_FunctionQueue.drain();
+				}
+			});
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		CIntParameter model("m", 0, -100000000, 100000000);
+		std::vector<MarshallingView> marshallingViews(executor ? 0 : viewCount);
+		std::vector<ExecutedView> executedViews(executor ? viewCount : 0);
+		for (MarshallingView & view : marshallingViews)
+			view.registerAt(&model);
+		for (ExecutedView & view : executedViews) {
+			view.setExecutor(&queue);
+			view.registerAt(&model);
+			}
+		const auto t0 = std::chrono::steady_clock::now();
+		for (int i = 1; i <= n; i++)
+			model.assignValue(i);
+		running = false;
+		owner.join();
+		const auto t1 = std::chrono::steady_clock::now();
+		std::printf("%s: %.1f ns per delivered update, wrong thread %ld\n",
+			executor ? "View::setExecutor(ExecutorQueue)          " : "view re-marshals (std::function, condvar)",
+			std::chrono::duration<double, std::nano>(t1 - t0).count() / n / viewCount, s_WrongThread.load());
+		for (MarshallingView & view : marshallingViews)
+			view.unregisterAt(&model);
+		for (ExecutedView & view : executedViews)
+			view.unregisterAt(&model);
+		}
+	return 0;
+}
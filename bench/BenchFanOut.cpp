@@ -0,0 +1,92 @@
+/**
+ * Parallel fan-out benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Duration of a notification of many views, serial and by the FanOutPool.
+ * The worker count is fixed once the pool runs, hence every parallel
+ * measurement runs in a process of its own: BenchFanOut [n [workers]]
+ */
+
+#include "../model/Parameter.h"
+#include "../mvc/FanOutPool.h"
+#include "../mvc/View.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+static std::atomic<long> s_Updates(0);
+
+// -------------------------------------------------------
+class WorkingView : public mvc::View {
+public:
+	virtual void update(const mvc::Model *, void *) override {
+		volatile unsigned int x = 0;
+		for (int i = 0; i < 200; i++)
+			x += i;
+		s_Updates.fetch_add(1, std::memory_order_relaxed);
+	}
+};
+
+// -------------------------------------------------------
+int main(int argc, char ** argv) {
+	const int viewCount = 4096, n = (argc > 1) ? std::atoi(argv[1]) : 200;
+	if (argc <= 2) {
+		// A process per worker count, 0 measures the serial update
+		for (unsigned int workers : { 0u, 1u, 2u, 4u, 8u }) {
+			const std::string command = std::string(argv[0]) + " " + std::to_string(n) + " " + std::to_string(workers);
+			if (std::system(command.c_str()) != 0)
+				return 1;
+			}
+		return 0;
+		}
+	const unsigned int workers = unsigned(std::atoi(argv[2]));
+	CIntParameter model("units", 0, -100000000, 100000000);
+	std::vector<WorkingView> views(viewCount);
+	for (WorkingView & view : views)
+		view.registerAt(&model);
+	if (workers > 0) {
+		mvc::FanOutPool::setWorkerCount(workers);
+		model.setParallelFanOut(256);
+		}
+	model.assignValue(-1);
+	s_Updates = 0;
+	const auto t0 = std::chrono::steady_clock::now();
+	for (int i = 1; i <= n; i++)
+		model.assignValue(i);
+	const auto t1 = std::chrono::steady_clock::now();
+	std::printf("%s %u workers: %.1f us per notification of %d views (complete=%d)\n",
+		workers ? "parallel" : "serial  ", workers, std::chrono::duration<double, std::micro>(t1 - t0).count() / n,
+		viewCount, s_Updates.load() == long(n) * viewCount);
+	for (WorkingView & view : views)
+		view.unregisterAt(&model);
+	return 0;
+}
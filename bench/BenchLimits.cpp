@@ -0,0 +1,94 @@
+/**
+ * Limits benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Reader scaling of TNumParameter::getNextValue(): the limits are read under a
+ * shared lock, hence readers do not serialize. Nanoseconds per read and reads
+ * per microsecond of all readers, without and with a writer assigning values.
+ */
+
+#include "../model/Parameter.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+static volatile long s_Sink = 0;
+
+// -------------------------------------------------------
+// Returns the nanoseconds per read of each reader
+static double run(int readerCount, bool writer, long reads) {
+	CIntParameter gain("gain", 0, -1000000, 1000000, 3);
+	std::atomic<bool> start(false), running(true);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < readerCount; t++) {
+		threads.emplace_back([&]() {
+			while (!start)
+				std::this_thread::yield();
+			long sum = 0;
+			for (long i = 0; i < reads; i++)
+				sum += gain.getNextValue();
+			s_Sink = s_Sink + sum;
+			});
+		}
+	std::thread writerThread;
+	if (writer) {
+		writerThread = std::thread([&]() {
+			while (!start)
+				std::this_thread::yield();
+			for (int i = 0; running; i++) {
+				gain.assignValue(i % 1000);
+				std::this_thread::sleep_for(std::chrono::microseconds(10));
+				}
+			});
+		}
+	const auto t0 = std::chrono::steady_clock::now();
+	start = true;
+	for (std::thread & thread : threads)
+		thread.join();
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+	running = false;
+	if (writer)
+		writerThread.join();
+	return ns / reads;
+}
+
+// -------------------------------------------------------
+int main() {
+	const long reads = 1000000;
+	std::printf("%-10s  %12s  %12s  %14s  %14s\n", "readers", "ns/read", "ns/read+W", "reads/us", "reads/us+W");
+	for (int readerCount : { 1, 2, 4, 8 }) {
+		const double alone  = run(readerCount, false, reads);
+		const double writer = run(readerCount, true, reads);
+		std::printf("%-10d  %12.1f  %12.1f  %14.1f  %14.1f\n", readerCount, alone, writer,
+			1000.0 * readerCount / alone, 1000.0 * readerCount / writer);
+		}
+	return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * Load benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Lock-free load() versus the locked getValue(), and torn reads of a large
+ * value assigned concurrently
+ */
+
+#include "../model/Parameter.h"
+#include "../sync/Synchronized.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+struct Quad {
+	bool operator!=(const Quad & r) const { return m_A != r.m_A || m_B != r.m_B || m_C != r.m_C || m_D != r.m_D; }
+	uint64_t m_A, m_B, m_C, m_D;
+};
+
+static double nanoseconds(std::chrono::steady_clock::time_point t0, long n) {
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+// -------------------------------------------------------
+int main() {
+	CIntParameter parameter("p", 0, -1000000000, 1000000000);
+	const long n = 20000000;
+	long sum = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for (long i = 0; i < n; i++)
+		sum += parameter.load();
+	std::printf("load()           : %.2f ns\n", nanoseconds(t0, n));
+	t0 = std::chrono::steady_clock::now();
+	for (long i = 0; i < n; i++) {
+		sync::CMutex & mutex = parameter.getMutex();
+		synchronized(mutex) {
+			sum += parameter.getValue();
+			}
+		}
+	std::printf("locked getValue(): %.2f ns\n", nanoseconds(t0, n));
+	t0 = std::chrono::steady_clock::now();
+	for (long i = 0; i < n / 10; i++)
+		parameter.assignValue(int(i % 1000));
+	std::printf("assignValue()    : %.1f ns\n", nanoseconds(t0, n / 10));
+
+	mvc::TModel<Quad> model("quad", Quad{ 0, 0, 0, 0 });
+	std::atomic<bool> running(true);
+	std::atomic<long> torn(0), reads(0);
+	std::vector<std::thread> readers, writers;
+	for (int r = 0; r < 2; r++) {
+		readers.emplace_back([&]() {
+			long count = 0;
+			while (running) {
+				const Quad value = model.load();
+				if (value.m_A != value.m_B || value.m_B != value.m_C || value.m_C != value.m_D)
+					torn++;
+				count++;
+				}
+			reads += count;
+			});
+		}
+	for (int w = 0; w < 2; w++) {
+		writers.emplace_back([&model, w]() {
+			for (uint64_t i = 1; i <= 300000; i++) {
+				const uint64_t x = i * 2 + w;
+				model.assignValue(Quad{ x, x, x, x });
+				}
+			});
+		}
+	for (std::thread & writer : writers)
+		writer.join();
+	running = false;
+	for (std::thread & reader : readers)
+		reader.join();
+	std::printf("torn reads: %ld of %ld\n", torn.load(), reads.load());
+	return (sum == 42) ? 1 : 0;
+}
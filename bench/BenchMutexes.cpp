@@ -0,0 +1,91 @@
+/**
+ * Mutex benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Nanoseconds per synchronized block of the mutex classes, depending on the
+ * number of threads and the work done while locked
+ */
+
+#include "../sync/Mutexes.h"
+#include "../sync/Synchronized.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+
+static volatile unsigned long s_Counter = 0;
+static volatile double        s_Work = 1.0;
+
+// -------------------------------------------------------
+template <class M> double run(int threadCount, int work, long total) {
+	M mutex;
+	std::atomic<bool> start(false);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; t++) {
+		threads.emplace_back([&]() {
+			while (!start)
+				std::this_thread::yield();
+			for (long i = 0; i < total / threadCount; i++) {
+				synchronized(mutex) {
+					s_Counter = s_Counter + 1;
+					for (int w = 0; w < work; w++)
+						s_Work = s_Work * 1.0000001;
+					}
+				}
+			});
+		}
+	const auto t0 = std::chrono::steady_clock::now();
+	start = true;
+	for (std::thread & thread : threads)
+		thread.join();
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / total;
+}
+
+template <class M> void row(const char * label) {
+	const long n = 2000000;
+	std::printf("%-28s", label);
+	for (int threadCount : { 1, 2, 4 })
+		for (int work : { 0, 50 })
+			std::printf("  %6.1f", run<M>(threadCount, work, work ? n / 10 : n));
+	std::printf("\n");
+}
+
+// -------------------------------------------------------
+int main() {
+	std::printf("%-28s", "ns per lock, threads/work");
+	for (int threadCount : { 1, 2, 4 })
+		for (int work : { 0, 50 })
+			std::printf("  %dT/%3d", threadCount, work);
+	std::printf("\n");
+	row<sync::CMutex>("CMutex");
+	row<sync::CPlainMutex>("CPlainMutex");
+	row<sync::CSpinMutex>("CSpinMutex");
+	row<sync::CAdaptiveMutex>("CAdaptiveMutex");
+	return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * Notification benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Cost of a notification for the caller, throughput and delivery latency of
+ * synchronous and asynchronous models, and the cost per registered view.
+ */
+
+#include "../mvc/Model.h"
+#include "../mvc/View.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+
+typedef std::chrono::steady_clock Clock;
+
+static std::atomic<long>      s_Updates(0);
+static std::atomic<long long> s_Latency(0);
+
+// -------------------------------------------------------
+// Measures the latency if the notification carries a time stamp
+class LatencyView : public mvc::View {
+public:
+	virtual void update(const mvc::Model *, void * pObject) override {
+		if (pObject != nullptr)
+			s_Latency += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - *static_cast<Clock::time_point *>(pObject)).count();
+		s_Updates++;
+	}
+};
+
+class NotifyingModel : public mvc::Model {
+public:
+	NotifyingModel() : mvc::Model("m") {}
+	void fire(void * pObject = nullptr) { setChanged(); notifyAll(pObject); }
+};
+
+// -------------------------------------------------------
+static void benchDelivery() {
+	for (int viewCount : { 1, 10, 1000 }) {
+		for (bool syncMode : { true, false }) {
+			NotifyingModel model;
+			model.setSyncMode(syncMode);
+			std::vector<LatencyView> views(viewCount);
+			for (LatencyView & view : views)
+				view.registerAt(&model);
+			const int n = std::max(2000, 2000000 / viewCount);
+			s_Updates = 0;
+			const Clock::time_point t0 = Clock::now();
+			for (int i = 0; i < n; i++)
+				model.fire();
+			const Clock::time_point t1 = Clock::now();
+			while (s_Updates < long(n) * viewCount)
+				std::this_thread::yield();
+			const Clock::time_point t2 = Clock::now();
+
+			// Latency of single notifications, end to end
+			const int samples = 2000;
+			Clock::time_point stamp;
+			s_Updates = 0;
+			s_Latency = 0;
+			for (int i = 0; i < samples; i++) {
+				stamp = Clock::now();
+				model.fire(&stamp);
+				while (s_Updates < long(i + 1) * viewCount)
+					;
+				}
+			std::printf("views=%5d %-5s caller %6.0f ns/notify, throughput %9.0f notifications/s, mean latency %7.1f us\n",
+				viewCount, syncMode ? "sync" : "async",
+				std::chrono::duration<double, std::nano>(t1 - t0).count() / n,
+				n / std::chrono::duration<double>(t2 - t0).count(),
+				s_Latency / 1000.0 / (double(samples) * viewCount));
+			for (LatencyView & view : views)
+				view.unregisterAt(&model);
+			}
+		}
+}
+
+// -------------------------------------------------------
+static void benchViewCount() {
+	for (int viewCount : { 1, 2, 4, 10, 100, 1000, 10000 }) {
+		NotifyingModel model;
+		std::vector<std::unique_ptr<LatencyView>> views;
+		for (int i = 0; i < viewCount; i++)
+			views.emplace_back(new LatencyView());
+		// Registered in shuffled order of allocation, as in long-lived heaps
+		for (int i = 0; i < viewCount; i++)
+			views[(i * 7919) % viewCount]->registerAt(&model);
+		const long n = std::max(200L, 20000000L / viewCount);
+		const Clock::time_point t0 = Clock::now();
+		for (long i = 0; i < n; i++)
+			model.fire();
+		const Clock::time_point t1 = Clock::now();
+		for (int i = 0; i < viewCount; i++)
+			views[i]->unregisterAt(&model);
+		const Clock::time_point t2 = Clock::now();
+		const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+		std::printf("%6d views: %10.1f ns/notify (%.2f ns/view), unregister all %.1f us\n",
+			viewCount, ns, ns / viewCount, std::chrono::duration<double, std::micro>(t2 - t1).count());
+		}
+}
+
+// -------------------------------------------------------
+int main() {
+	benchDelivery();
+	benchViewCount();
+	return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * Queue benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Throughput of the lock-free queues versus a vector under a mutex, single and
+ * batched transfers
+ */
+
+#include "../sync/Queues.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+
+typedef std::chrono::steady_clock Clock;
+
+static double millionsPerSecond(Clock::time_point t0, long n) {
+	return n / std::chrono::duration<double>(Clock::now() - t0).count() / 1e6;
+}
+
+// -------------------------------------------------------
+// A vector under a mutex, swapped out by the consumer
+class VectorQueue {
+public:
+	VectorQueue() : m_Closed(false) {}
+	void push(const long * pItems, size_t n) {
+		bool wasEmpty;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			wasEmpty = m_Items.empty();
+			m_Items.insert(m_Items.end(), pItems, pItems + n);
+		}
+		if (wasEmpty)
+			m_Condition.notify_one();
+	}
+	size_t pop(std::vector<long> & items) {
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this]() { return !m_Items.empty() || m_Closed; });
+		items.clear();
+		items.swap(m_Items);
+		return items.size();
+	}
+	void close() {
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Closed = true;
+		}
+		m_Condition.notify_all();
+	}
+private:
+	std::vector<long>       m_Items;
+	std::mutex              m_Mutex;
+	std::condition_variable m_Condition;
+	bool                    m_Closed;
+};
+
+// Fills a batch of items of a producer, tagged with the producer
+static size_t fill(std::vector<long> & buffer, int producer, long first, long perProducer) {
+	const size_t n = size_t(std::min<long>(long(buffer.size()), perProducer - first));
+	for (size_t k = 0; k < n; k++)
+		buffer[k] = long(producer) << 40 | (first + long(k));
+	return n;
+}
+
+// -------------------------------------------------------
+template <class Q> double runLockFree(Q & queue, int producers, long perProducer, size_t batch) {
+	const Clock::time_point t0 = Clock::now();
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; p++) {
+		threads.emplace_back([&, p]() {
+			std::vector<long> buffer(batch);
+			for (long i = 0; i < perProducer; ) {
+				const size_t n = fill(buffer, p, i, perProducer);
+				size_t done = 0;
+				while (done < n) {
+					size_t count = queue.tryPush(buffer.data() + done, n - done);
+					if (count == 0) {
+						queue.push(buffer[done]);
+						count = 1;
+						}
+					done += count;
+					}
+				i += long(n);
+				}
+			});
+		}
+	std::thread closer([&]() {
+		for (std::thread & thread : threads)
+			thread.join();
+		queue.close();
+		});
+	std::vector<long> last(producers, -1);
+	long received = 0, disordered = 0;
+	long items[256];
+	while (size_t n = queue.pop(items, 256)) {
+		for (size_t k = 0; k < n; k++) {
+			const int p = int(items[k] >> 40);
+			const long i = items[k] & ((1L << 40) - 1);
+			if (i != last[p] + 1)
+				disordered++;
+			last[p] = i;
+			}
+		received += long(n);
+		}
+	closer.join();
+	if (received != producers * perProducer || disordered != 0)
+		std::printf("  ERROR received %ld, disordered %ld\n", received, disordered);
+	return millionsPerSecond(t0, received);
+}
+
+double runVector(int producers, long perProducer, size_t batch) {
+	VectorQueue queue;
+	const Clock::time_point t0 = Clock::now();
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; p++) {
+		threads.emplace_back([&, p]() {
+			std::vector<long> buffer(batch);
+			for (long i = 0; i < perProducer; ) {
+				const size_t n = fill(buffer, p, i, perProducer);
+				queue.push(buffer.data(), n);
+				i += long(n);
+				}
+			});
+		}
+	std::thread closer([&]() {
+		for (std::thread & thread : threads)
+			thread.join();
+		queue.close();
+		});
+	std::vector<long> items;
+	long received = 0;
+	while (size_t n = queue.pop(items))
+		received += long(n);
+	closer.join();
+	return millionsPerSecond(t0, received);
+}
+
+// -------------------------------------------------------
+int main(int argc, char ** argv) {
+	const long n = 4000000;
+	const size_t capacity = (argc > 1) ? size_t(std::atol(argv[1])) : 1024;
+	std::printf("capacity %zu\n", capacity);
+	for (size_t batch : { size_t(1), size_t(32) }) {
+		sync::TSpscQueue<long> spsc(capacity);
+		std::printf("SPSC batch %2zu: lock-free %6.1f M/s, mutex and vector %6.1f M/s\n",
+			batch, runLockFree(spsc, 1, n, batch), runVector(1, n, batch));
+		sync::TMpscQueue<long> mpsc(capacity);
+		std::printf("MPSC 4 producers batch %2zu: lock-free %6.1f M/s, mutex and vector %6.1f M/s\n",
+			batch, runLockFree(mpsc, 4, n / 4, batch), runVector(4, n / 4, batch));
+		}
+	return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * View benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Cost of a view update: classic views reading the model back, typed views,
+ * subscriptions and filtered typed views
+ */
+
+#include "../model/Parameter.h"
+#include "../mvc/View.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+static long s_Sum = 0;
+static long s_Redraws = 0;
+
+// -------------------------------------------------------
+// Casts the model and reads the value back
+class ClassicView : public mvc::View {
+public:
+	virtual void update(const mvc::Model * pModel, void *) override {
+		s_Sum += const_cast<CIntParameter *>(dynamic_cast<const CIntParameter *>(pModel))->getValue();
+	}
+};
+
+// Filters the updates itself
+class FilteringView : public mvc::View {
+public:
+	FilteringView() : m_Last(0) {}
+	virtual void update(const mvc::Model * pModel, void *) override {
+		const int value = const_cast<CIntParameter *>(dynamic_cast<const CIntParameter *>(pModel))->getValue();
+		if (std::abs(value - m_Last) >= 100) {
+			m_Last = value;
+			s_Redraws++;
+			}
+	}
+private:
+	int m_Last;
+};
+
+class TypedView : public mvc::TView<int> {
+public:
+	virtual void update(const mvc::TModel<int> *, const int & value, const int &) override {
+		s_Sum += value;
+		s_Redraws++;
+	}
+};
+
+// Assigns n values, returns the duration in nanoseconds
+static double assign(CIntParameter & model, int n) {
+	const auto t0 = std::chrono::steady_clock::now();
+	for (int i = 1; i <= n; i++)
+		model.assignValue(i);
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// -------------------------------------------------------
+static void benchUpdates() {
+	const int viewCount = 8, n = 200000;
+	{
+		CIntParameter model("m", 0, -100000000, 100000000);
+		std::vector<ClassicView> views(viewCount);
+		for (ClassicView & view : views)
+			view.registerAt(&model);
+		std::printf("View   (dynamic_cast, getValue): %.1f ns per view update\n", assign(model, n) / n / viewCount);
+		for (ClassicView & view : views)
+			view.unregisterAt(&model);
+	}
+	{
+		CIntParameter model("m", 0, -100000000, 100000000);
+		std::vector<TypedView> views(viewCount);
+		for (TypedView & view : views)
+			view.registerAt(&model);
+		std::printf("TView  (value, oldValue)       : %.1f ns per view update\n", assign(model, n) / n / viewCount);
+	}
+	{
+		CIntParameter model("m", 0, -100000000, 100000000);
+		for (int k = 0; k < viewCount; k++)
+			model.subscribe([](const int & value, const int &) { s_Sum += value; });
+		std::printf("subscribe(callback)            : %.1f ns per view update\n", assign(model, n) / n / viewCount);
+	}
+}
+
+// -------------------------------------------------------
+static void benchFilters() {
+	const int viewCount = 64, n = 100000;
+	{
+		CIntParameter model("m", 0, -100000000, 100000000);
+		std::vector<FilteringView> views(viewCount);
+		for (FilteringView & view : views)
+			view.registerAt(&model);
+		s_Redraws = 0;
+		const double ns = assign(model, n);
+		std::printf("View filtering itself   : %.1f ns per assignment, %ld redraws\n", ns / n, s_Redraws);
+		for (FilteringView & view : views)
+			view.unregisterAt(&model);
+	}
+	{
+		CIntParameter model("m", 0, -100000000, 100000000);
+		std::vector<TypedView> views(viewCount);
+		for (TypedView & view : views)
+			view.registerAt(&model);
+		s_Redraws = 0;
+		const double ns = assign(model, n);
+		std::printf("TView unfiltered        : %.1f ns per assignment, %ld redraws\n", ns / n, s_Redraws);
+	}
+	{
+		CIntParameter model("m", 0, -100000000, 100000000);
+		std::vector<TypedView> views(viewCount);
+		for (TypedView & view : views)
+			view.registerFilteredAt(&model, mvc::TModel<int>::deadband(100));
+		s_Redraws = 0;
+		const double ns = assign(model, n);
+		std::printf("TView with deadband(100): %.1f ns per assignment, %ld redraws\n", ns / n, s_Redraws);
+	}
+}
+
+// -------------------------------------------------------
+int main() {
+	benchUpdates();
+	benchFilters();
+	return s_Sum == 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * Voter benchmark of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * vote() calls of a voter shared by many models, within transactions and for
+ * repeated validations of unchanged models
+ */
+
+#include "../model/Parameter.h"
+#include "../mvc/Transaction.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+static long s_Votes = 0;
+static std::vector<std::unique_ptr<CIntParameter>> s_Models;
+
+// -------------------------------------------------------
+// Consistency check over all models: the sum must stay below a limit
+class SumVoter : public mvc::TVoter<int> {
+public:
+	SumVoter() {
+		for (auto & upModel : s_Models)
+			dependsOn(upModel.get());
+	}
+	virtual bool vote() override {
+		s_Votes++;
+		long sum = 0;
+		for (auto & upModel : s_Models)
+			sum += upModel->getValue();
+		for (volatile int k = 0; k < 2000; k++) {}
+		return sum < 1000000;
+	}
+};
+
+// -------------------------------------------------------
+int main() {
+	const int modelCount = 48, n = 20000;
+	for (int i = 0; i < modelCount; i++)
+		s_Models.emplace_back(new CIntParameter("m" + std::to_string(i), 0, -1000000, 1000000));
+	auto spVoter = std::make_shared<SumVoter>();
+	for (auto & upModel : s_Models)
+		upModel->setVoter(spVoter);
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (int i = 1; i <= n; i++) {
+		mvc::Transaction transaction;
+		for (auto & upModel : s_Models)
+			upModel->assignValue(i);
+		transaction.commit();
+		}
+	auto t1 = std::chrono::steady_clock::now();
+	std::printf("transaction of %d models sharing a voter: %.2f vote() calls, %.2f us per commit\n",
+		modelCount, double(s_Votes) / n, std::chrono::duration<double, std::micro>(t1 - t0).count() / n);
+
+	s_Votes = 0;
+	bool valid = true;
+	t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < n; i++)
+		for (auto & upModel : s_Models)
+			valid &= upModel->validateAssignment();
+	t1 = std::chrono::steady_clock::now();
+	std::printf("validateAssignment of unchanged models: %.3f vote() calls, %.3f us per call (valid=%d)\n",
+		double(s_Votes) / (n * modelCount), std::chrono::duration<double, std::micro>(t1 - t0).count() / (n * modelCount), valid);
+	return 0;
+}
@@ -91,7 +91,7 @@ public:
      * @param range the specified range of this enum. parameter
      */
 	CEnumParameter(std::string name, int initValue, var_array<int> range);
-	virtual ~CEnumParameter() {};
+	virtual ~CEnumParameter() { mvc::Model::cancelNotifications(); };
     
     /**
      * @return the currently valid range within the range of specified values.
@@ -136,7 +136,7 @@ public:
 	TNumParameter(const T & initValue);
 
 	TNumParameter() : de::bswalz::model::TParameter<T>(), m_pNumLimits(nullptr) { }
-    virtual ~TNumParameter() {};
+    virtual ~TNumParameter() { mvc::Model::cancelNotifications(); };
 
 	/**
 	 * Assigns a new value to the model. The method checks
@@ -205,8 +205,9 @@ protected:
     T              m_MinValue;
     T              m_MaxValue;
     T              m_Step;
-    sync::CMutex   m_Mutex;
     TNumLimits<T>* m_pNumLimits;
+    sync::CSharedMutex m_LimitsMutex; // Guards the limits and the step, shared by the read paths
+    using mvc::Model::m_Mutex;       // Guards m_Value, as for all models
 };
 
 
@@ -219,7 +220,7 @@ public:
 	TVarArrayParameter(const std::string & name, const de::bswalz::var_array<T> & initValue);
 	TVarArrayParameter(const de::bswalz::var_array<T> & initValue);
     TVarArrayParameter();
-    virtual ~TVarArrayParameter() {};
+    virtual ~TVarArrayParameter() { mvc::Model::cancelNotifications(); };
 
     /**
      * Assigns a new value to the model.
@@ -274,7 +275,7 @@ public:
 
 protected:
     unsigned int  m_Size;
-    sync::CMutex  m_Mutex;
+    using mvc::Model::m_Mutex;      // Guards m_Value, as for all models
 };
 
 
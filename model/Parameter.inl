@@ -12,6 +12,7 @@ TParameter<T>::TParameter(const std::string & name, T initValue, bool syncMode)
 // -----------------------------------------------------------
 template <typename T>
 TParameter<T>::~TParameter() {
+	mvc::Model::cancelNotifications();
 	if (m_spRelevanceParameter.get())
 		mvc::View::unregisterAt(m_spRelevanceParameter.get());
 };
@@ -22,6 +23,8 @@ void TParameter<T>::setRelevance(bool relevant) {
 	if (m_spRelevanceParameter.get())
 		{ m_spRelevanceParameter->assignValue(relevant); }
 	else {
+		if (m_Relevance != relevant)
+			mvc::Model::stampEpoch();
 		m_Relevance = relevant;
 		mvc::Model::setChanged();
 		mvc::Model::notifyAll();
@@ -44,7 +47,14 @@ bool TParameter<T>::isDefaultValue() const {
 // -----------------------------------------------------------
 template <typename T>
 void TParameter<T>::setDefaultValue() {
-	TParameter<T>::m_Value = m_DefaultValue;
+	sync::CMutex & mutex = mvc::Model::m_Mutex;
+	synchronized(mutex) {
+		if (TParameter<T>::m_Value != m_DefaultValue)
+			mvc::Model::stampEpoch();
+		TParameter<T>::m_Value = m_DefaultValue;
+		mvc::Model::advanceRevision();
+		mvc::TModel<T>::publishValue();
+		} // End synchronized
 	mvc::Model::setChanged();
 	mvc::Model::notifyAll();
 };
@@ -52,8 +62,10 @@ void TParameter<T>::setDefaultValue() {
 // -----------------------------------------------------------
 template <typename T>
 void TParameter<T>::update(const mvc::Model * pModel, void *) {
-	if (pModel == m_spRelevanceParameter.get())
+	if (pModel == m_spRelevanceParameter.get() && m_Relevance != m_spRelevanceParameter->getValue()) {
 		m_Relevance = m_spRelevanceParameter->getValue();
+		mvc::Model::stampEpoch();
+		}
 	mvc::Model::setChanged();
 	mvc::Model::notifyAll();
 }
@@ -82,23 +94,47 @@ TNumParameter<T>::TNumParameter(const T & initValue)
 template <typename T>
 bool TNumParameter<T>::assignValue(const T & value, const IAssignRule* pRule) {
 	bool success = true;
+	if (mvc::Transaction::getCurrent() != nullptr
+	    || (pRule == nullptr && !mvc::TModel<T>::m_pAssignRules.empty() && mvc::RuleGraph::reachesFanIn(this))) {
+		T limitedValue;
+		synchronized_shared(m_LimitsMutex) {
+			if      (value < getMinValue()) limitedValue = getMinValue();
+			else if (value > getMaxValue()) limitedValue = getMaxValue();
+			else                            limitedValue = value;
+			} // End synchronized
+		if (mvc::TModel<T>::assignTransacted(limitedValue, pRule, success))
+			return success;
+		}
+
 	if (!mvc::Model::hasChanged()) {
 		synchronized(m_Mutex) {
-			T m_CurrValue = mvc::TModel<T>::m_Value;
-			if      (value < getMinValue()) mvc::TModel<T>::m_Value = getMinValue();
-			else if (value > getMaxValue()) mvc::TModel<T>::m_Value = getMaxValue();
-			else                            mvc::TModel<T>::m_Value = value;
-
-			mvc::TModel<T>::applyAssignRules();
-
-			if (pRule == nullptr && !mvc::TModel<T>::validateAssignment()) {
-				// Validation only on originally assigned parameter, not on assignment caused by AssignRule
-				mvc::TModel<T>::revertAssignment();
-				success = false;
+			if (!mvc::Model::isAssignable(nullptr)) {
+				success = false; // Assigned by the open transaction of another thread
 				}
-			if (m_CurrValue != value) { // Notifies also if value has been limited
-				m_CurrValue = mvc::TModel<T>::m_Value;
-				mvc::Model::setChanged();
+			else {
+				mvc::TModel<T>::m_CurrValue = mvc::TModel<T>::m_Value;
+				synchronized_shared(m_LimitsMutex) {
+					if      (value < getMinValue()) mvc::TModel<T>::m_Value = getMinValue();
+					else if (value > getMaxValue()) mvc::TModel<T>::m_Value = getMaxValue();
+					else                            mvc::TModel<T>::m_Value = value;
+					} // End synchronized
+				mvc::Model::advanceRevision();
+
+				mvc::TModel<T>::applyAssignRules();
+
+				if (pRule == nullptr && !mvc::TModel<T>::validateAssignment()) {
+					// Validation only on originally assigned parameter, not on assignment caused by AssignRule
+					mvc::TModel<T>::revertAssignment();
+					success = false;
+					}
+				else {
+					mvc::TModel<T>::stampIfChanged(mvc::TModel<T>::m_Value);
+					mvc::TModel<T>::publishValue(); // Only a validated value is published
+					}
+				if (mvc::TModel<T>::m_CurrValue != value) { // Notifies also if value has been limited
+					mvc::TModel<T>::m_CurrValue = mvc::TModel<T>::m_Value;
+					mvc::Model::setChanged();
+					}
 				}
 			} // End synchronized
       
@@ -106,6 +142,9 @@ bool TNumParameter<T>::assignValue(const T & value, const IAssignRule* pRule) {
 			mvc::Model::notifyAll();
 			}
 		} // End if hasChanged() == false
+	else {
+		success = false; // Dropped, the previous assignment is being notified
+		}
 	return success;
 };
 
@@ -119,10 +158,9 @@ void TNumParameter<T>::setDefaultValue() {
 // -----------------------------------------------------------
 template <typename T>
 T TNumParameter<T>::getMinValue() {
-	T minVal = m_MinValue;
-	synchronized(m_Mutex) {
-		if (m_pNumLimits != NULL)
-			minVal = m_pNumLimits->getMinValue(this);
+	T minVal;
+	synchronized_shared(m_LimitsMutex) {
+		minVal = (m_pNumLimits != NULL) ? m_pNumLimits->getMinValue(this) : m_MinValue;
 		} // End synchronized
 	return minVal;
 };
@@ -130,10 +168,9 @@ T TNumParameter<T>::getMinValue() {
 // -----------------------------------------------------------
 template <typename T>
 T TNumParameter<T>::getMaxValue() {
-	T maxVal = m_MaxValue;
-	synchronized(m_Mutex) {
-		if (m_pNumLimits != NULL)
-			maxVal = m_pNumLimits->getMaxValue(this);
+	T maxVal;
+	synchronized_shared(m_LimitsMutex) {
+		maxVal = (m_pNumLimits != NULL) ? m_pNumLimits->getMaxValue(this) : m_MaxValue;
 		} // End synchronized
 	return maxVal;
 };
@@ -142,9 +179,9 @@ T TNumParameter<T>::getMaxValue() {
 template <typename T>
 T TNumParameter<T>::getNextValue() {
 	T nextVal;
-	synchronized(m_Mutex) {
-		nextVal = (mvc::TModel<T>::m_Value <= (getMaxValue() - m_Step))
-				? (mvc::TModel<T>::m_Value + m_Step) : getMaxValue();
+	const T value = mvc::TModel<T>::load(); // The validated value, without the model mutex
+	synchronized_shared(m_LimitsMutex) {
+		nextVal = (value <= (getMaxValue() - m_Step)) ? (value + m_Step) : getMaxValue();
 		} // End synchronized
 	return nextVal;
 };
@@ -153,9 +190,9 @@ T TNumParameter<T>::getNextValue() {
 template <typename T>
 T TNumParameter<T>::getNextValueRotated() {
 	T nextVal;
-	synchronized(m_Mutex) {
-		nextVal = (mvc::TModel<T>::m_Value <= (getMaxValue() - m_Step))
-				? (mvc::TModel<T>::m_Value + m_Step) : getMinValue();
+	const T value = mvc::TModel<T>::load();
+	synchronized_shared(m_LimitsMutex) {
+		nextVal = (value <= (getMaxValue() - m_Step)) ? (value + m_Step) : getMinValue();
 		} // End synchronized
 	return nextVal;
 };
@@ -164,9 +201,9 @@ T TNumParameter<T>::getNextValueRotated() {
 template <typename T>
 T TNumParameter<T>::getPrevValue() {
 	T prevVal;
-	synchronized(m_Mutex) {
-		prevVal = (mvc::TModel<T>::m_Value >= (getMinValue() + m_Step))
-				? (mvc::TModel<T>::m_Value - m_Step) : getMinValue();
+	const T value = mvc::TModel<T>::load();
+	synchronized_shared(m_LimitsMutex) {
+		prevVal = (value >= (getMinValue() + m_Step)) ? (value - m_Step) : getMinValue();
 		} // End synchronized
 	return prevVal;
 };
@@ -175,9 +212,9 @@ T TNumParameter<T>::getPrevValue() {
 template <typename T>
 T TNumParameter<T>::getPrevValueRotated() {
 	T prevVal;
-	synchronized(m_Mutex) {
-		prevVal = (mvc::TModel<T>::m_Value >= (getMinValue() + m_Step))
-				? (mvc::TModel<T>::m_Value - m_Step) : getMaxValue();
+	const T value = mvc::TModel<T>::load();
+	synchronized_shared(m_LimitsMutex) {
+		prevVal = (value >= (getMinValue() + m_Step)) ? (value - m_Step) : getMaxValue();
 		} // End synchronized
 	return prevVal;
 };
@@ -185,7 +222,9 @@ T TNumParameter<T>::getPrevValueRotated() {
 // -----------------------------------------------------------
 template <typename T>
 void TNumParameter<T>::setNumLimits(TNumLimits<T> * pNumLimits) {
-	m_pNumLimits = pNumLimits;
+	synchronized_exclusive(m_LimitsMutex) {
+		m_pNumLimits = pNumLimits;
+		} // End synchronized
 }
 
 
@@ -214,30 +253,49 @@ TVarArrayParameter<T>::TVarArrayParameter()
 template <typename T>
 bool TVarArrayParameter<T>::assignValue(const de::bswalz::var_array<T> & value, const IAssignRule* pRule ) {
 	bool success = true;
+	if (mvc::TModel<de::bswalz::var_array<T>>::assignTransacted(value, pRule, success))
+		return success;
+
 	if (!mvc::Model::hasChanged()) {
 		synchronized(m_Mutex) {
-			mvc::TModel<de::bswalz::var_array<T>>::m_CurrValue = mvc::TModel<de::bswalz::var_array<T>>::m_Value;
-			mvc::TModel<de::bswalz::var_array<T>>::m_Value     = value;
-			mvc::TModel<de::bswalz::var_array<T>>::applyAssignRules();
-			if (pRule == nullptr && !mvc::TModel<var_array<T>>::validateAssignment()) {
-				// Validation only on originally assigned parameter, not on assignment caused by AssignRule
-				mvc::TModel<de::bswalz::var_array<T>>::revertAssignment();
-				success = false;
+			if (!mvc::Model::isAssignable(nullptr)) {
+				success = false; // Assigned by the open transaction of another thread
 				}
-			if (mvc::TModel<de::bswalz::var_array<T>>::m_CurrValue != value) { // Notifies also if value has been limited
+			else {
 				mvc::TModel<de::bswalz::var_array<T>>::m_CurrValue = mvc::TModel<de::bswalz::var_array<T>>::m_Value;
-				mvc::Model::setChanged();
+				mvc::TModel<de::bswalz::var_array<T>>::m_Value     = value;
+				mvc::Model::advanceRevision();
+				mvc::TModel<de::bswalz::var_array<T>>::applyAssignRules();
+				if (pRule == nullptr && !mvc::TModel<var_array<T>>::validateAssignment()) {
+					// Validation only on originally assigned parameter, not on assignment caused by AssignRule
+					mvc::TModel<de::bswalz::var_array<T>>::revertAssignment();
+					success = false;
+					}
+				else {
+					mvc::TModel<de::bswalz::var_array<T>>::stampIfChanged(value);
+					}
+				if (mvc::TModel<de::bswalz::var_array<T>>::m_CurrValue != value) { // Notifies also if value has been limited
+					mvc::TModel<de::bswalz::var_array<T>>::m_CurrValue = mvc::TModel<de::bswalz::var_array<T>>::m_Value;
+					mvc::Model::setChanged();
+					}
 				}
 			} // End synchronized
 		mvc::Model::notifyAll();
 		} // End if hasChanged() == false
+	else {
+		success = false; // Dropped, the previous assignment is being notified
+		}
 	return success;
 };
 
 // -----------------------------------------------------------
 template <typename T>
 void TVarArrayParameter<T>::assignElementValue(T value, unsigned int i) {
-	mvc::TModel<de::bswalz::var_array<T> >::m_Value[i] = value;
+	if (mvc::TModel<de::bswalz::var_array<T> >::m_Value[i] != value) {
+		mvc::TModel<de::bswalz::var_array<T> >::m_Value[i] = value;
+		mvc::Model::advanceRevision();
+		mvc::Model::stampEpoch();
+		}
 };
 
 // -----------------------------------------------------------
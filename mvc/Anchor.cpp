@@ -0,0 +1,53 @@
+/**
+ * Anchor class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Anchor.h"
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Class mvc::Anchor
+// -------------------------------------------------------
+Anchor::Anchor(void * pOwner)
+	: m_References(1), m_Mutex(), m_pOwner(pOwner)
+{ /* Intentionally left blank */ }
+
+// -------------------------------------------------------
+void Anchor::release() {
+	if (m_References.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		delete this;
+}
+
+// -------------------------------------------------------
+void Anchor::detach() {
+	synchronized(m_Mutex) {
+		// Deferred work running in another thread holds the mutex
+		m_pOwner = nullptr;
+		}
+	release();
+}
+
+}}} // End namespaces
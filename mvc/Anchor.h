@@ -0,0 +1,84 @@
+#ifndef _DE_BSWALZ_MVC_ANCHOR_H_
+#define _DE_BSWALZ_MVC_ANCHOR_H_
+
+/**
+ * Anchor class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../sync/Synchronized.h"
+#include <atomic>
+
+namespace de { namespace bswalz { namespace mvc {
+
+/**
+ * An Anchor refers to a model or a view and outlives it.<br>
+ * Deferred work, e.g. a notification posted to the Dispatcher, refers to its
+ * owner by a counted reference to the anchor. The owner detaches the anchor
+ * in its destructor: deferred work which has not yet started finds the anchor
+ * detached and is discarded, deferred work which is running is waited for.
+ */
+class Anchor {
+public:
+	/**
+	 * Constructor, the owner holds the first reference
+	 * @param pOwner the model or the view
+	 */
+	explicit Anchor(void * pOwner);
+
+	/** Adds a reference of deferred work */
+	void addReference() { m_References.fetch_add(1, std::memory_order_relaxed); }
+
+	/** Releases a reference, the last reference deletes the anchor */
+	void release();
+
+	/**
+	 * @return the mutex which is held while deferred work uses the owner
+	 */
+	sync::CMutex & getMutex() { return m_Mutex; }
+
+	/**
+	 * @return the owner or nullptr if detached. Called with locked mutex.
+	 */
+	void * getOwner() const { return m_pOwner; }
+
+	/**
+	 * Detaches the owner and releases its reference. Waits for deferred work
+	 * running in another thread. Called by the destructor of the owner.
+	 */
+	void detach();
+
+private:
+	Anchor(const Anchor &);
+	Anchor & operator=(const Anchor &);
+	~Anchor() {}
+
+	std::atomic<unsigned int> m_References;
+	sync::CMutex              m_Mutex;       // Recursive, the owner may be destroyed by its own deferred work
+	void *                    m_pOwner;      // Guarded by m_Mutex
+}; // End of class Anchor
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_ANCHOR_H_*/
@@ -0,0 +1,99 @@
+/**
+ * ChangeTracker class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ChangeTracker.h"
+#include "Model.h"
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Class mvc::ChangeTracker
+// -------------------------------------------------------
+ChangeTracker::ChangeTracker()
+	: m_Entries(), m_ModificationCount(0), m_Initial(false) {
+	// Intentionally left blank
+}
+
+// -------------------------------------------------------
+ChangeTracker::~ChangeTracker() {
+	// Intentionally left blank
+}
+
+// -------------------------------------------------------
+void ChangeTracker::track(const Model * pModel) {
+	for (auto & entry : m_Entries) {
+		if (entry.m_pModel == pModel)
+			return;
+		}
+	// No epoch equals UNSEEN, hence the model is reported by the next poll
+	m_Entries.push_back(Entry{ pModel, UNSEEN });
+	m_Initial = true;
+}
+
+// -------------------------------------------------------
+void ChangeTracker::untrack(const Model * pModel) {
+	for (auto it = m_Entries.begin(); it != m_Entries.end(); ++it) {
+		if (it->m_pModel == pModel) {
+			m_Entries.erase(it);
+			return;
+			}
+		}
+}
+
+// -------------------------------------------------------
+size_t ChangeTracker::poll(std::vector<const Model *> & changed) {
+	changed.clear();
+	// Read before the epochs: every modification counted here is visible by getEpoch()
+	const uint64_t modificationCount = Model::getModificationCount();
+	if (modificationCount == m_ModificationCount && !m_Initial)
+		return 0; // No model at all has been modified
+
+	for (auto & entry : m_Entries) {
+		const uint64_t epoch = entry.m_pModel->getEpoch();
+		if (epoch != entry.m_Epoch) {
+			entry.m_Epoch = epoch;
+			changed.push_back(entry.m_pModel);
+			}
+		}
+	m_ModificationCount = modificationCount;
+	m_Initial           = false;
+	return changed.size();
+}
+
+// -------------------------------------------------------
+bool ChangeTracker::hasChanged() const {
+	if (m_Initial)
+		return true;
+	if (Model::getModificationCount() == m_ModificationCount)
+		return false;
+	for (auto & entry : m_Entries) {
+		if (entry.m_pModel->getEpoch() != entry.m_Epoch)
+			return true;
+		}
+	return false;
+}
+
+}}} // End namespaces
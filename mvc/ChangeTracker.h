@@ -0,0 +1,107 @@
+#ifndef _DE_BSWALZ_MVC_CHANGETRACKER_H_
+#define _DE_BSWALZ_MVC_CHANGETRACKER_H_
+
+/**
+ * ChangeTracker class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of ChangeTracker
+ * -------------------------------------------------------------------------
+ *	// A view rendering at a fixed frame rate pulls the latest state, it is not registered
+ *	mvc::ChangeTracker tracker;
+ *	tracker.track(m_pGainParameter.get());
+ *	tracker.track(m_pBalanceParameter.get());
+ *	...
+ *	// At frame time
+ *	std::vector<const mvc::Model *> changed;
+ *	if (tracker.poll(changed) > 0) {
+ *		for (auto pModel : changed) redraw(pModel);
+ *		}
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+class Model;
+
+/**
+ * The ChangeTracker answers which of a set of models have been modified since
+ * the last poll, without any notification. It compares the epochs of the models
+ * (Model::getEpoch()) with the epochs seen at the last poll. If no model at all has
+ * been modified in the meantime, poll() returns after one atomic load.<br>
+ * A tracker is used by a single thread, e.g. the render loop.
+ */
+class ChangeTracker {
+public:
+	ChangeTracker();
+	virtual ~ChangeTracker();
+
+	/**
+	 * Adds a model to the tracked models. The model is reported by the next poll().
+	 * The model has to outlive the tracker or has to be untracked.
+	 * @param pModel the model
+	 */
+	void track(const Model * pModel);
+
+	/**
+	 * Removes a model from the tracked models
+	 * @param pModel the model
+	 */
+	void untrack(const Model * pModel);
+
+	/**
+	 * Collects the models modified since the last poll
+	 * @param changed receives the modified models, in order of track()
+	 * @return the number of modified models
+	 */
+	size_t poll(std::vector<const Model *> & changed);
+
+	/**
+	 * @return true if a tracked model has been modified since the last poll
+	 */
+	bool hasChanged() const;
+
+private:
+	ChangeTracker(const ChangeTracker &);
+	ChangeTracker & operator=(const ChangeTracker &);
+
+	struct Entry {
+		const Model * m_pModel;
+		uint64_t      m_Epoch;        // Epoch seen at the last poll
+	};
+
+	static const uint64_t UNSEEN = ~uint64_t(0);
+
+	std::vector<Entry> m_Entries;
+	uint64_t           m_ModificationCount; // Model::getModificationCount() before the last poll
+	bool               m_Initial;           // Tracked models not yet reported
+}; // End of class ChangeTracker
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_CHANGETRACKER_H_*/
@@ -0,0 +1,233 @@
+#ifndef _DE_BSWALZ_MVC_CHANGES_H_
+#define _DE_BSWALZ_MVC_CHANGES_H_
+
+/**
+ * Awaitable model changes of MVC pattern for C++20 coroutines
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of TChanges
+ * -------------------------------------------------------------------------
+ *	// A coroutine of a service, resumed by the service's own executor
+ *	Task watchGain(model::CIntParameter * pGain, mvc::IExecutor * pExecutor) {
+ *		auto changes = pGain->changed(pExecutor, true);
+ *		for (;;) {
+ *			int gain = co_await changes;   // The latest value, bursts are coalesced
+ *			apply(gain);
+ *			}
+ *		}
+ *
+ *	// Waiting for the next change only
+ *	int gain = co_await pGain->changed();
+ */
+
+#if defined(__cpp_impl_coroutine)
+
+#include "Model.h"
+#include "Executor.h"
+#include <coroutine>
+#include <memory>
+#include <mutex>
+
+namespace de { namespace bswalz { namespace mvc {
+
+/**
+ * Template class TChanges, an awaitable stream of the values of a TModel<T>,
+ * created by TModel<T>::changed().<br>
+ * Every co_await suspends until the model has been notified and returns the
+ * latest value. Notifications between two awaits are coalesced, a slow consumer
+ * never builds up a backlog. Neither the notification nor the resumption allocates.<br>
+ * A stream is awaited by one coroutine at a time. The model must outlive the stream.
+ * Destroying the stream, e.g. with the frame of a cancelled coroutine, discards
+ * a resumption still queued at the executor.
+ */
+template <typename T> class TChanges {
+public:
+	TChanges(TChanges && r);
+	TChanges & operator=(TChanges && r);
+	virtual ~TChanges();
+
+	/** @return true if a value is pending, co_await does not suspend */
+	bool await_ready() const;
+
+	/**
+	 * Suspends the awaiting coroutine until the next notification
+	 * @param handle the awaiting coroutine
+	 * @return false if a value became pending meanwhile
+	 */
+	bool await_suspend(std::coroutine_handle<> handle);
+
+	/** @return the latest notified value */
+	T    await_resume();
+
+private:
+	friend class TModel<T>;
+
+	// Shared by the stream, the callback of the subscription and the queued resumption
+	struct State : std::enable_shared_from_this<State> {
+		std::mutex              m_Mutex;
+		T                       m_Value;
+		bool                    m_Pending = false;
+		bool                    m_Queued = false;   // A resumption is queued at the executor
+		std::coroutine_handle<> m_Waiter;           // Cleared by close() and by the resumption
+		IExecutor *             m_pExecutor = nullptr;
+
+		void push(const T & value);
+		void resume();
+	};
+
+	TChanges(TModel<T> * pModel, IExecutor * pExecutor, bool initialUpdate);
+	TChanges(const TChanges &);
+	TChanges & operator=(const TChanges &);
+
+	void close();
+
+	TModel<T> *            m_pModel;
+	unsigned int           m_Id;
+	std::shared_ptr<State> m_spState;
+}; // End of template <class T> TChanges
+
+
+// -------------------------------------------------------
+// Template class TChanges<T>
+// -------------------------------------------------------
+template <typename T>
+TChanges<T>::TChanges(TModel<T> * pModel, IExecutor * pExecutor, bool initialUpdate)
+	: m_pModel(pModel), m_Id(0), m_spState(std::make_shared<State>()) {
+	m_spState->m_pExecutor   = pExecutor;
+	std::shared_ptr<State> spState = m_spState;
+	m_Id = pModel->subscribe(
+		[spState](const T & value, const T &) { spState->push(value); }, initialUpdate);
+};
+
+// -------------------------------------------------------
+template <typename T>
+TChanges<T>::TChanges(TChanges && r)
+	: m_pModel(r.m_pModel), m_Id(r.m_Id), m_spState(std::move(r.m_spState)) {
+	r.m_pModel = nullptr;
+};
+
+// -------------------------------------------------------
+template <typename T>
+TChanges<T> & TChanges<T>::operator=(TChanges && r) {
+	if (this != &r) {
+		close();
+		m_pModel   = r.m_pModel;
+		m_Id       = r.m_Id;
+		m_spState  = std::move(r.m_spState);
+		r.m_pModel = nullptr;
+		}
+	return *this;
+};
+
+// -------------------------------------------------------
+template <typename T>
+TChanges<T>::~TChanges() {
+	close();
+};
+
+// -------------------------------------------------------
+template <typename T>
+void TChanges<T>::close() {
+	if (m_pModel == nullptr)
+		return;
+	m_pModel->unsubscribe(m_Id);
+	m_pModel = nullptr;
+	// A notification already dispatched must not resume a destroyed coroutine
+	std::lock_guard<std::mutex> lock(m_spState->m_Mutex);
+	m_spState->m_Waiter = std::coroutine_handle<>();
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TChanges<T>::await_ready() const {
+	std::lock_guard<std::mutex> lock(m_spState->m_Mutex);
+	return m_spState->m_Pending;
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TChanges<T>::await_suspend(std::coroutine_handle<> handle) {
+	std::lock_guard<std::mutex> lock(m_spState->m_Mutex);
+	if (m_spState->m_Pending)
+		return false;
+	m_spState->m_Waiter = handle;
+	return true;
+};
+
+// -------------------------------------------------------
+template <typename T>
+T TChanges<T>::await_resume() {
+	std::lock_guard<std::mutex> lock(m_spState->m_Mutex);
+	m_spState->m_Pending = false;
+	return m_spState->m_Value;
+};
+
+// -------------------------------------------------------
+template <typename T>
+void TChanges<T>::State::push(const T & value) {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Value   = value;
+		m_Pending = true;
+		if (!m_Waiter || m_Queued)
+			return; // Coalesced, the consumer takes the latest value at its next await
+		m_Queued = (m_pExecutor != nullptr);
+	}
+	if (m_pExecutor != nullptr) {
+		// The waiter stays registered until the task runs, close() may still withdraw it
+		m_pExecutor->execute([spState = this->shared_from_this()]() { spState->resume(); });
+		}
+	else
+		resume();
+};
+
+// -------------------------------------------------------
+template <typename T>
+void TChanges<T>::State::resume() {
+	std::coroutine_handle<> waiter;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Queued = false;
+		waiter   = m_Waiter;
+		m_Waiter = std::coroutine_handle<>();
+	}
+	if (waiter)
+		waiter.resume(); // Not if the stream has been closed meanwhile
+};
+
+
+// -------------------------------------------------------
+// Template class TModel<T>
+// -------------------------------------------------------
+template <typename T>
+TChanges<T> TModel<T>::changed(IExecutor * pExecutor, bool initialUpdate) {
+	return TChanges<T>(this, pExecutor, initialUpdate);
+};
+
+}}} // End of namespaces
+
+#endif /* __cpp_impl_coroutine */
+
+#endif /*_DE_BSWALZ_MVC_CHANGES_H_*/
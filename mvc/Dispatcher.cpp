@@ -0,0 +1,140 @@
+/**
+ * Dispatcher class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Dispatcher.h"
+#include <cstdint>
+#include <stdexcept>
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Class mvc::Dispatcher
+// -------------------------------------------------------
+Dispatcher *                Dispatcher::m_pInstance      = nullptr;
+bool                        Dispatcher::m_Shutdown       = false;
+unsigned int                Dispatcher::m_WorkerCount    = 0;
+std::mutex                  Dispatcher::m_InstanceMutex;
+
+// -------------------------------------------------------
+Dispatcher * Dispatcher::getInstance() {
+	std::lock_guard<std::mutex> lock(m_InstanceMutex);
+	if (m_pInstance == nullptr && !m_Shutdown)
+		m_pInstance = new Dispatcher(getWorkerCount());
+	return m_pInstance;
+}
+
+// -------------------------------------------------------
+void Dispatcher::shutdown() {
+	Dispatcher * pOldInstance;
+	{
+		std::lock_guard<std::mutex> lock(m_InstanceMutex);
+		m_Shutdown   = true;
+		pOldInstance = m_pInstance;
+		m_pInstance  = nullptr;
+	}
+	// The pool finishes its pending tasks outside of the lock
+	delete pOldInstance;
+}
+
+// -------------------------------------------------------
+void Dispatcher::setWorkerCount(unsigned int workerCount) {
+	std::lock_guard<std::mutex> lock(m_InstanceMutex);
+	if (m_pInstance != nullptr || m_Shutdown)
+		throw std::logic_error("Dispatcher::setWorkerCount(): the pool has already been started");
+	m_WorkerCount = (workerCount > 0) ? workerCount : 1;
+}
+
+// -------------------------------------------------------
+unsigned int Dispatcher::getWorkerCount() {
+	if (m_WorkerCount == 0) {
+		unsigned int hwCount = std::thread::hardware_concurrency();
+		return (hwCount > 0) ? hwCount : 1;
+		}
+	return m_WorkerCount;
+}
+
+// -------------------------------------------------------
+Dispatcher::Dispatcher(unsigned int workerCount)
+	: m_Workers() {
+	for (unsigned int i = 0; i < workerCount; i++) {
+		m_Workers.emplace_back(new Worker());
+		m_Workers.back()->m_Tasks.reserve(INITIAL_CAPACITY);
+		}
+	for (auto & upWorker : m_Workers) {
+		Worker * pWorker   = upWorker.get();
+		pWorker->m_Thread  = std::thread(&Dispatcher::run, this, pWorker);
+		}
+}
+
+// -------------------------------------------------------
+Dispatcher::~Dispatcher() {
+	for (auto & upWorker : m_Workers) {
+		std::lock_guard<std::mutex> lock(upWorker->m_Mutex);
+		upWorker->m_Stopped = true;
+		upWorker->m_Condition.notify_one();
+		}
+	for (auto & upWorker : m_Workers) {
+		if (upWorker->m_Thread.joinable())
+			upWorker->m_Thread.join();
+		}
+}
+
+// -------------------------------------------------------
+void Dispatcher::post(const void * pKey, Task task) {
+	// Pointers are aligned, hence the lower bits are dropped before hashing
+	std::uintptr_t hash = (reinterpret_cast<std::uintptr_t>(pKey) >> 4) * 0x9E3779B1u;
+	Worker * pWorker = m_Workers[hash % m_Workers.size()].get();
+	{
+		std::lock_guard<std::mutex> lock(pWorker->m_Mutex);
+		pWorker->m_Tasks.push_back(std::move(task));
+	}
+	pWorker->m_Condition.notify_one();
+}
+
+// -------------------------------------------------------
+// run() runs in separate thread.
+void Dispatcher::run(Worker * pWorker) {
+	// Both vectors keep their capacity, no heap allocation once they are warm
+	std::vector<Task> tasks;
+	tasks.reserve(INITIAL_CAPACITY);
+	std::unique_lock<std::mutex> lock(pWorker->m_Mutex);
+	for (;;) {
+		pWorker->m_Condition.wait(lock, [pWorker]() {
+			return pWorker->m_Stopped || !pWorker->m_Tasks.empty(); });
+		if (pWorker->m_Tasks.empty())
+			break; // Stopped and all pending tasks are done
+
+		tasks.swap(pWorker->m_Tasks);
+		lock.unlock();
+		for (auto & task : tasks) {
+			task();
+			}
+		tasks.clear();
+		lock.lock();
+		}
+}
+
+}}} // End namespaces
@@ -0,0 +1,116 @@
+#ifndef _DE_BSWALZ_MVC_DISPATCHER_H_
+#define _DE_BSWALZ_MVC_DISPATCHER_H_
+
+/**
+ * Dispatcher class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+/**
+ * The Dispatcher is a pool with a fixed number of worker threads, which
+ * executes the update notifications of models in non-synchronized mode.<br>
+ * Every task is posted with a key (usually the source model). Tasks with the
+ * same key are executed by the same worker in the order they have been posted,
+ * hence the views of a model receive their updates in order.
+ */
+class Dispatcher {
+public:
+	typedef std::function<void()> Task;
+
+	/**
+	 * @return the dispatcher instance. The worker threads are started at first call.
+	 * After shutdown() nullptr is returned, the caller executes its task itself.
+	 */
+	static Dispatcher * getInstance();
+
+	/**
+	 * Finishes the pending tasks and stops the worker threads for good.<br>
+	 * The instance is never destroyed by the static destruction at exit, hence
+	 * its user (the Model::UpdateManager) calls shutdown() explicitly at exit,
+	 * after its own thread has been stopped. No task is posted afterwards.
+	 */
+	static void shutdown();
+
+	/**
+	 * Sets the number of worker threads.<br>
+	 * Has to be called at start-up, before the first notification in
+	 * non-synchronized mode. A running pool is never replaced: its users
+	 * hold the instance without a lock, and the tasks of a key would be
+	 * spread over two pools, which breaks their order.
+	 * @param workerCount the number of worker threads (at least 1)
+	 * @throws std::logic_error if the pool has already been started
+	 */
+	static void setWorkerCount(unsigned int workerCount);
+
+	/**
+	 * @return the number of worker threads
+	 */
+	static unsigned int getWorkerCount();
+
+	/**
+	 * Posts a task to the worker which is associated with the key
+	 * @param pKey the key (e.g. the source model)
+	 * @param task the task to be executed
+	 */
+	void post(const void * pKey, Task task);
+
+	virtual ~Dispatcher();
+
+private:
+	Dispatcher(unsigned int workerCount);
+	Dispatcher(const Dispatcher &);
+	Dispatcher & operator=(const Dispatcher &);
+
+	struct Worker {
+		std::thread             m_Thread;
+		std::vector<Task>       m_Tasks;      // Swapped out as a whole by run()
+		std::mutex              m_Mutex;
+		std::condition_variable m_Condition;
+		bool                    m_Stopped = false;
+	};
+
+	void run(Worker * pWorker);
+
+	static const size_t INITIAL_CAPACITY = 256;
+
+	std::vector<std::unique_ptr<Worker>>  m_Workers;
+
+	static Dispatcher *                   m_pInstance;   // Not destroyed at exit, see shutdown()
+	static bool                           m_Shutdown;
+	static unsigned int                   m_WorkerCount;
+	static std::mutex                     m_InstanceMutex;
+}; // End of class Dispatcher
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_DISPATCHER_H_*/
@@ -0,0 +1,115 @@
+/**
+ * Executor classes of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Executor.h"
+#ifdef __linux__
+#include <cstdint>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Class mvc::ExecutorQueue
+// -------------------------------------------------------
+ExecutorQueue::ExecutorQueue()
+	: m_Tasks(), m_Running(), m_Fd(-1) {
+	m_Tasks.reserve(INITIAL_CAPACITY);
+	m_Running.reserve(INITIAL_CAPACITY);
+#ifdef __linux__
+	m_Fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+// -------------------------------------------------------
+ExecutorQueue::~ExecutorQueue() {
+#ifdef __linux__
+	if (m_Fd >= 0)
+		::close(m_Fd);
+#endif
+}
+
+// -------------------------------------------------------
+void ExecutorQueue::execute(Task task) {
+	bool wasEmpty;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		wasEmpty = m_Tasks.empty();
+		m_Tasks.push_back(std::move(task));
+	}
+	// Only the first task signals, runPending() takes all queued tasks
+	if (wasEmpty) {
+#ifdef __linux__
+		if (m_Fd >= 0) {
+			const uint64_t one = 1;
+			ssize_t written = ::write(m_Fd, &one, sizeof(one));
+			(void)written; // The counter saturates only after 2^64 - 2 signals
+			return;
+			}
+#endif
+		m_Condition.notify_one();
+		}
+}
+
+// -------------------------------------------------------
+size_t ExecutorQueue::runPending() {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Running.swap(m_Tasks);
+#ifdef __linux__
+		if (m_Fd >= 0) {
+			uint64_t count;
+			ssize_t read = ::read(m_Fd, &count, sizeof(count));
+			(void)read; // Resets the eventfd, fails with EAGAIN if not signaled
+			}
+#endif
+	}
+	const size_t count = m_Running.size();
+	for (auto & task : m_Running) {
+		task();
+		}
+	m_Running.clear();
+	return count;
+}
+
+// -------------------------------------------------------
+bool ExecutorQueue::wait(std::chrono::milliseconds timeout) {
+#ifdef __linux__
+	if (m_Fd >= 0) {
+		struct pollfd pfd;
+		pfd.fd      = m_Fd;
+		pfd.events  = POLLIN;
+		pfd.revents = 0;
+		return ::poll(&pfd, 1, static_cast<int>(timeout.count())) > 0;
+		}
+#endif
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	return m_Condition.wait_for(lock, timeout, [this]() { return !m_Tasks.empty(); });
+}
+
+}}} // End namespaces
@@ -0,0 +1,119 @@
+#ifndef _DE_BSWALZ_MVC_EXECUTOR_H_
+#define _DE_BSWALZ_MVC_EXECUTOR_H_
+
+/**
+ * Executor classes of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of ExecutorQueue
+ * -------------------------------------------------------------------------
+ *	// The view is updated by the render loop only
+ *	mvc::ExecutorQueue renderQueue;
+ *	m_pGainView->setExecutor(&renderQueue);
+ *	m_pGainView->registerAt(m_pGainParameter.get());
+ *
+ *	// Render loop, e.g. with poll() or epoll on renderQueue.getFileDescriptor()
+ *	while (running) {
+ *		renderQueue.wait(std::chrono::milliseconds(16));
+ *		renderQueue.runPending();
+ *		render();
+ *		}
+ */
+
+#include "../InplaceFunction.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+/**
+ * An executor runs tasks in a context of its own, e.g. the thread of an I/O or
+ * a render loop. A view with an executor receives its updates by this executor.
+ * @see View::setExecutor()
+ */
+class IExecutor {
+public:
+	/** A task, stored inline without heap allocation */
+	typedef de::bswalz::inplace_function<void()> Task;
+
+	virtual ~IExecutor() = 0;
+
+	/**
+	 * Queues a task. Called by any thread.
+	 * @param task the task to be executed by the executor
+	 */
+	virtual void execute(Task task) = 0;
+};
+inline IExecutor::~IExecutor() {}
+
+/**
+ * An executor queue drained by the thread owning it.<br>
+ * On Linux the queue signals queued tasks by an eventfd, hence the owning
+ * thread may wait for tasks together with other file descriptors.
+ */
+class ExecutorQueue : public IExecutor {
+public:
+	ExecutorQueue();
+	virtual ~ExecutorQueue();
+
+	virtual void execute(Task task) override;
+
+	/**
+	 * Executes all queued tasks. Called by the owning thread, not by a task.
+	 * @return the number of executed tasks
+	 */
+	size_t runPending();
+
+	/**
+	 * Waits until a task is queued
+	 * @param timeout the maximum time to wait
+	 * @return true if a task is queued
+	 */
+	bool wait(std::chrono::milliseconds timeout);
+
+	/**
+	 * @return the file descriptor which becomes readable if a task is queued,
+	 * -1 if not supported by the platform
+	 */
+	int getFileDescriptor() const { return m_Fd; }
+
+private:
+	ExecutorQueue(const ExecutorQueue &);
+	ExecutorQueue & operator=(const ExecutorQueue &);
+
+	static const size_t INITIAL_CAPACITY = 256;
+
+	std::vector<Task>       m_Tasks;      // Swapped out as a whole by runPending()
+	std::vector<Task>       m_Running;
+	std::mutex              m_Mutex;
+	std::condition_variable m_Condition;  // Used if there is no file descriptor
+	int                     m_Fd;
+}; // End of class ExecutorQueue
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_EXECUTOR_H_*/
@@ -0,0 +1,252 @@
+/**
+ * FanOutPool class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FanOutPool.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Class mvc::FanOutPool::Completion
+// -------------------------------------------------------
+FanOutPool::Completion::Completion(const RangeTask & task, size_t chunkCount)
+	: m_Task(task), m_Remaining(chunkCount), m_Done(chunkCount == 0), m_Exception(), m_spSelf() {
+	// Intentionally left blank
+}
+
+// -------------------------------------------------------
+void FanOutPool::Completion::wait() {
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Condition.wait(lock, [this]() { return m_Done; });
+	if (m_Exception)
+		std::rethrow_exception(m_Exception);
+}
+
+// -------------------------------------------------------
+void FanOutPool::Completion::execute(size_t begin, size_t end) {
+	try {
+		m_Task(begin, end);
+		}
+	catch (...) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_Exception)
+			m_Exception = std::current_exception();
+		}
+	if (m_Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		// The waiter returns after the mutex has been released: a completion on the
+		// stack of run() is destroyed then, it is not touched afterwards.
+		std::shared_ptr<Completion> spSelf;
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		spSelf.swap(m_spSelf);
+		m_Done = true;
+		m_Condition.notify_all();
+		}
+}
+
+// -------------------------------------------------------
+// Class mvc::FanOutPool
+// -------------------------------------------------------
+std::unique_ptr<FanOutPool> FanOutPool::m_upInstance     = std::unique_ptr<FanOutPool>();
+unsigned int                FanOutPool::m_WorkerCount    = 0;
+std::mutex                  FanOutPool::m_InstanceMutex;
+
+// -------------------------------------------------------
+FanOutPool * FanOutPool::getInstance() {
+	std::lock_guard<std::mutex> lock(m_InstanceMutex);
+	if (m_upInstance.get() == nullptr)
+		m_upInstance.reset(new FanOutPool(getWorkerCount()));
+	return m_upInstance.get();
+}
+
+// -------------------------------------------------------
+void FanOutPool::setWorkerCount(unsigned int workerCount) {
+	std::lock_guard<std::mutex> lock(m_InstanceMutex);
+	if (m_upInstance.get() != nullptr)
+		throw std::logic_error("FanOutPool::setWorkerCount(): the pool has already been started");
+	m_WorkerCount = (workerCount > 0) ? workerCount : 1;
+}
+
+// -------------------------------------------------------
+unsigned int FanOutPool::getWorkerCount() {
+	if (m_WorkerCount == 0) {
+		unsigned int hwCount = std::thread::hardware_concurrency();
+		return (hwCount > 0) ? hwCount : 1;
+		}
+	return m_WorkerCount;
+}
+
+// -------------------------------------------------------
+FanOutPool::FanOutPool(unsigned int workerCount)
+	: m_Workers(), m_Queued(0), m_NextWorker(0), m_Stopped(false) {
+	for (unsigned int i = 0; i < workerCount; i++) {
+		m_Workers.emplace_back(new Worker());
+		m_Workers.back()->m_Ring.resize(INITIAL_CAPACITY);
+		}
+	for (auto & upWorker : m_Workers) {
+		Worker * pWorker   = upWorker.get();
+		pWorker->m_Thread  = std::thread(&FanOutPool::work, this, pWorker);
+		}
+}
+
+// -------------------------------------------------------
+FanOutPool::~FanOutPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_IdleMutex);
+		m_Stopped = true;
+	}
+	m_IdleCondition.notify_all();
+	for (auto & upWorker : m_Workers) {
+		if (upWorker->m_Thread.joinable())
+			upWorker->m_Thread.join();
+		}
+}
+
+// -------------------------------------------------------
+// @return the number of items per chunk
+static size_t getChunkSize(size_t count, size_t workerCount, size_t chunkSize) {
+	if (chunkSize == 0) // About four chunks per worker balance the load
+		chunkSize = (count + 4 * workerCount - 1) / (4 * workerCount);
+	return (chunkSize > 0) ? chunkSize : 1;
+}
+
+// -------------------------------------------------------
+std::shared_ptr<FanOutPool::Completion> FanOutPool::submit(size_t count, const RangeTask & task, size_t chunkSize) {
+	chunkSize = getChunkSize(count, m_Workers.size(), chunkSize);
+	std::shared_ptr<Completion> spCompletion(new Completion(task, (count + chunkSize - 1) / chunkSize));
+	if (count > 0) {
+		spCompletion->m_spSelf = spCompletion; // Released by the last chunk
+		distribute(spCompletion.get(), count, chunkSize);
+		}
+	return spCompletion;
+}
+
+// -------------------------------------------------------
+void FanOutPool::run(size_t count, const RangeTask & task, size_t chunkSize) {
+	chunkSize = getChunkSize(count, m_Workers.size(), chunkSize);
+	Completion completion(task, (count + chunkSize - 1) / chunkSize);
+	if (count > 0)
+		distribute(&completion, count, chunkSize);
+	// The calling thread steals chunks instead of being idle; a worker calling
+	// run() this way never waits for chunks that nobody processes.
+	Chunk chunk;
+	while (!completion.isDone() && take(nullptr, chunk))
+		chunk.m_pCompletion->execute(chunk.m_Begin, chunk.m_End);
+	completion.wait();
+}
+
+// -------------------------------------------------------
+// Pushes the chunks of a range round robin to the back of the deques
+void FanOutPool::distribute(Completion * pCompletion, size_t count, size_t chunkSize) {
+	const size_t workerCount = m_Workers.size();
+	const size_t chunkCount  = (count + chunkSize - 1) / chunkSize;
+	// Counted in advance, hence m_Queued never drops below the number of queued chunks
+	m_Queued.fetch_add(chunkCount, std::memory_order_release);
+	size_t worker = m_NextWorker.fetch_add(1, std::memory_order_relaxed);
+	for (size_t begin = 0; begin < count; begin += chunkSize, worker++) {
+		Worker * pWorker = m_Workers[worker % workerCount].get();
+		std::lock_guard<std::mutex> lock(pWorker->m_Mutex);
+		if (pWorker->m_Size == pWorker->m_Ring.size()) {
+			// Full: unrolled into a ring of twice the size
+			std::vector<Chunk> ring(2 * pWorker->m_Ring.size());
+			for (size_t i = 0; i < pWorker->m_Size; i++)
+				ring[i] = pWorker->m_Ring[(pWorker->m_Head + i) % pWorker->m_Ring.size()];
+			pWorker->m_Ring.swap(ring);
+			pWorker->m_Head = 0;
+			}
+		pWorker->m_Ring[(pWorker->m_Head + pWorker->m_Size) % pWorker->m_Ring.size()] =
+			Chunk{ pCompletion, begin, std::min(begin + chunkSize, count) };
+		pWorker->m_Size++;
+		}
+	{
+		// Pairs with the predicate check of the idle workers, no wake-up is lost
+		std::lock_guard<std::mutex> lock(m_IdleMutex);
+	}
+	if (chunkCount > 1)
+		m_IdleCondition.notify_all();
+	else
+		m_IdleCondition.notify_one();
+}
+
+// -------------------------------------------------------
+// Takes a chunk from the back of the own deque or steals from the front of another deque
+bool FanOutPool::take(Worker * pWorker, Chunk & chunk) {
+	if (m_Queued.load(std::memory_order_acquire) == 0)
+		return false;
+
+	if (pWorker != nullptr) {
+		std::lock_guard<std::mutex> lock(pWorker->m_Mutex);
+		if (pWorker->m_Size > 0) {
+			pWorker->m_Size--;
+			chunk = pWorker->m_Ring[(pWorker->m_Head + pWorker->m_Size) % pWorker->m_Ring.size()];
+			m_Queued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+			}
+		}
+
+	const size_t workerCount = m_Workers.size();
+	const size_t start       = m_NextWorker.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < workerCount; i++) {
+		Worker * pVictim = m_Workers[(start + i) % workerCount].get();
+		if (pVictim == pWorker)
+			continue;
+		std::lock_guard<std::mutex> lock(pVictim->m_Mutex);
+		if (pVictim->m_Size > 0) {
+			chunk = pVictim->m_Ring[pVictim->m_Head];
+			pVictim->m_Head = (pVictim->m_Head + 1) % pVictim->m_Ring.size();
+			pVictim->m_Size--;
+			m_Queued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+			}
+		}
+	return false;
+}
+
+// -------------------------------------------------------
+// work() runs in separate thread.
+void FanOutPool::work(Worker * pWorker) {
+	Chunk chunk;
+	for (;;) {
+		if (take(pWorker, chunk)) {
+			chunk.m_pCompletion->execute(chunk.m_Begin, chunk.m_End);
+			continue;
+			}
+
+		std::unique_lock<std::mutex> lock(m_IdleMutex);
+		if (m_Queued.load(std::memory_order_acquire) > 0) {
+			// The chunks are counted, but not yet pushed by distribute()
+			lock.unlock();
+			std::this_thread::yield();
+			continue;
+			}
+		m_IdleCondition.wait(lock, [this]() {
+			return m_Stopped || m_Queued.load(std::memory_order_acquire) > 0; });
+		if (m_Stopped && m_Queued.load(std::memory_order_acquire) == 0)
+			break; // Stopped and all pending chunks are done
+		}
+}
+
+}}} // End namespaces
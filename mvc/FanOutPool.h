@@ -0,0 +1,183 @@
+#ifndef _DE_BSWALZ_MVC_FANOUTPOOL_H_
+#define _DE_BSWALZ_MVC_FANOUTPOOL_H_
+
+/**
+ * FanOutPool class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of FanOutPool
+ * -------------------------------------------------------------------------
+ *	// Parallel update of the views, if at least 256 views are registered.
+ *	// The views have to be thread-safe, their order of update is unspecified.
+ *	m_pUnitsParameter->setParallelFanOut(256);
+ *
+ *	// Direct application: the calling thread helps and waits for completion
+ *	mvc::FanOutPool::getInstance()->run(items.size(), [&](size_t begin, size_t end) {
+ *		for (size_t i = begin; i < end; i++) process(items[i]);
+ *		});
+ *
+ *	// Asynchronous application with a completion barrier
+ *	auto spCompletion = mvc::FanOutPool::getInstance()->submit(items.size(), task);
+ *	...
+ *	spCompletion->wait();
+ */
+
+#include "../InplaceFunction.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+/**
+ * The FanOutPool is a work-stealing pool of worker threads which executes a
+ * range of work items in parallel, e.g. the update of thousands of views of a
+ * single model.<br>
+ * The range is split into chunks which are distributed to the workers' deques.
+ * A worker takes the chunks of its own deque and steals from the other deques
+ * when its own deque is empty.<br>
+ * Once the deques have grown to their working size, run() does not allocate:
+ * the completion barrier lives on the caller's stack and the task is stored inline.
+ */
+class FanOutPool {
+public:
+	/** Processes the items [begin, end) of a range, stored inline like IExecutor::Task */
+	typedef de::bswalz::inplace_function<void(size_t begin, size_t end)> RangeTask;
+
+	/**
+	 * The completion barrier of a submitted range
+	 */
+	class Completion {
+	public:
+		/**
+		 * Waits until all chunks of the range have been processed.
+		 * Rethrows the first exception thrown by the task.
+		 */
+		void wait();
+
+		/** @return true if all chunks of the range have been processed */
+		bool isDone() const { return m_Remaining.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class FanOutPool;
+		Completion(const RangeTask & task, size_t chunkCount);
+		Completion(const Completion &);
+		Completion & operator=(const Completion &);
+
+		void execute(size_t begin, size_t end);
+
+		RangeTask               m_Task;
+		std::atomic<size_t>     m_Remaining;
+		std::mutex              m_Mutex;
+		std::condition_variable m_Condition;
+		bool                    m_Done;       // Set by the last chunk, guarded by m_Mutex
+		std::exception_ptr      m_Exception;
+		std::shared_ptr<Completion> m_spSelf; // Keeps a submitted range until its last chunk, guarded by m_Mutex
+	}; // End of nested class Completion
+
+	/**
+	 * @return the pool instance. The worker threads are started at first call.
+	 */
+	static FanOutPool * getInstance();
+
+	/**
+	 * Sets the number of worker threads.<br>
+	 * Has to be called at start-up, before the first parallel fan-out. A running
+	 * pool is never replaced, its callers hold the instance without a lock.
+	 * @param workerCount the number of worker threads (at least 1)
+	 * @throws std::logic_error if the pool has already been started
+	 */
+	static void setWorkerCount(unsigned int workerCount);
+
+	/**
+	 * @return the number of worker threads
+	 */
+	static unsigned int getWorkerCount();
+
+	/**
+	 * Distributes the range [0, count) to the workers
+	 * @param count the number of items
+	 * @param task the task processing a chunk of items
+	 * @param chunkSize the number of items per chunk, 0 selects a size by the number of workers
+	 * @return the completion barrier of the range
+	 */
+	std::shared_ptr<Completion> submit(size_t count, const RangeTask & task, size_t chunkSize = 0);
+
+	/**
+	 * Processes the range [0, count) in parallel. The calling thread helps
+	 * processing chunks and returns, when the whole range has been processed.
+	 * @param count the number of items
+	 * @param task the task processing a chunk of items
+	 * @param chunkSize the number of items per chunk, 0 selects a size by the number of workers
+	 */
+	void run(size_t count, const RangeTask & task, size_t chunkSize = 0);
+
+	virtual ~FanOutPool();
+
+private:
+	FanOutPool(unsigned int workerCount);
+	FanOutPool(const FanOutPool &);
+	FanOutPool & operator=(const FanOutPool &);
+
+	struct Chunk {
+		Completion * m_pCompletion;
+		size_t       m_Begin;
+		size_t       m_End;
+	};
+
+	struct Worker {
+		std::thread             m_Thread;
+		std::vector<Chunk>      m_Ring;       // Deque of m_Size chunks from m_Head on, grows only
+		size_t                  m_Head = 0;   // Own chunks at the back, stolen at the front
+		size_t                  m_Size = 0;
+		std::mutex              m_Mutex;
+	};
+
+	void distribute(Completion * pCompletion, size_t count, size_t chunkSize);
+	bool take(Worker * pWorker, Chunk & chunk);
+	void work(Worker * pWorker);
+
+	std::vector<std::unique_ptr<Worker>>  m_Workers;
+	std::atomic<size_t>                   m_Queued;      // Number of chunks in all deques
+	std::atomic<size_t>                   m_NextWorker;  // Round robin distribution
+	std::mutex                            m_IdleMutex;
+	std::condition_variable               m_IdleCondition;
+	bool                                  m_Stopped;
+
+	static const size_t INITIAL_CAPACITY = 64;
+
+	static std::unique_ptr<FanOutPool>    m_upInstance;
+	static unsigned int                   m_WorkerCount;
+	static std::mutex                     m_InstanceMutex;
+}; // End of class FanOutPool
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_FANOUTPOOL_H_*/
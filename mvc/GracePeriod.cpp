@@ -0,0 +1,91 @@
+/**
+ * Grace period of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GracePeriod.h"
+#include <chrono>
+#include <thread>
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Nesting depth of the read sections of the current thread. Every thread updating
+// a view counts: the notifying thread, the Dispatcher, the FanOutPool and the executors.
+static thread_local unsigned int t_ReaderDepth = 0;
+
+// Serializes the grace periods
+static std::mutex s_GraceMutex;
+
+// -------------------------------------------------------
+// Class mvc::GracePeriod
+// -------------------------------------------------------
+GracePeriod::Scope::Scope() {
+	t_ReaderDepth++;
+}
+
+// -------------------------------------------------------
+GracePeriod::Scope::~Scope() {
+	t_ReaderDepth--;
+}
+
+// -------------------------------------------------------
+// Counts the reader in the current phase before any snapshot is loaded
+GracePeriod::Reader::Reader(GracePeriod & grace)
+	: m_Scope(), m_pCount(nullptr) {
+	for (;;) {
+		const unsigned int phase = grace.m_Phase.load();
+		m_pCount = &grace.m_Readers[phase & 1];
+		m_pCount->fetch_add(1);
+		if (grace.m_Phase.load() == phase)
+			break;
+		m_pCount->fetch_sub(1);
+		}
+}
+
+// -------------------------------------------------------
+bool GracePeriod::isReader() {
+	return t_ReaderDepth > 0;
+}
+
+// -------------------------------------------------------
+bool GracePeriod::synchronize() {
+	// A reader waiting for other readers could deadlock, e.g. two views unregistering each other
+	if (isReader())
+		return false;
+
+	// A reader which may have loaded an old snapshot is counted in the old
+	// phase, readers of the new phase load the new snapshot.
+	std::lock_guard<std::mutex> lock(s_GraceMutex);
+	const unsigned int phase = m_Phase.fetch_add(1);
+	for (unsigned int spins = 0; m_Readers[phase & 1].load(std::memory_order_acquire) > 0; spins++) {
+		if (spins < 64)
+			std::this_thread::yield();
+		else
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+	return true;
+}
+
+}}} // End namespaces
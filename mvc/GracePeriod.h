@@ -0,0 +1,165 @@
+#ifndef _DE_BSWALZ_MVC_GRACEPERIOD_H_
+#define _DE_BSWALZ_MVC_GRACEPERIOD_H_
+
+/**
+ * Grace period of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+/**
+ * A GracePeriod protects immutable snapshots which are read without any lock,
+ * e.g. the registered views of a model. Readers count themselves in the current
+ * phase, a writer which has unpublished a snapshot advances the phase and waits
+ * until the readers of the old phase are done (read-copy-update). Reading costs
+ * two atomic increments, no lock and no reference count of the snapshot.<br>
+ * A thread which reads (e.g. within View::update()) never waits for a grace
+ * period, it could wait for itself; the snapshots it unpublishes are deferred.
+ */
+class GracePeriod {
+public:
+	GracePeriod() : m_Readers(), m_Phase(0) {}
+
+	/**
+	 * Marks the current thread as a reader of any grace period, e.g. while it
+	 * updates a view. Scopes nest.
+	 */
+	class Scope {
+	public:
+		Scope();
+		~Scope();
+	private:
+		Scope(const Scope &);
+		Scope & operator=(const Scope &);
+	};
+
+	/**
+	 * Counts the current thread as a reader of a grace period. Snapshots are
+	 * loaded after construction and must not be used after destruction.
+	 */
+	class Reader {
+	public:
+		explicit Reader(GracePeriod & grace);
+		~Reader() { m_pCount->fetch_sub(1, std::memory_order_release); }
+	private:
+		Reader(const Reader &);
+		Reader & operator=(const Reader &);
+		Scope                       m_Scope;
+		std::atomic<unsigned int> * m_pCount;
+	};
+
+	/**
+	 * @return true if the current thread is within a Scope or a Reader
+	 */
+	static bool isReader();
+
+	/**
+	 * Waits until every reader which may have loaded a snapshot unpublished
+	 * before this call is done. Must not be called while holding a lock taken
+	 * by the readers.
+	 * @return false if the current thread is a reader itself, nothing is waited for then
+	 */
+	bool synchronize();
+
+private:
+	GracePeriod(const GracePeriod &);
+	GracePeriod & operator=(const GracePeriod &);
+
+	std::atomic<unsigned int> m_Readers[2];   // Readers by phase
+	std::atomic<unsigned int> m_Phase;        // Advanced by synchronize()
+}; // End of class GracePeriod
+
+
+/**
+ * An atomic pointer to an immutable snapshot of type S, protected by a
+ * GracePeriod. Readers load() the snapshot within a GracePeriod::Reader.
+ * A writer publishes a copy by exchange() while holding its own lock and
+ * retires the old snapshot after the lock has been released.
+ */
+template <typename S> class TRcuPointer {
+public:
+	explicit TRcuPointer(GracePeriod & grace) : m_Grace(grace), m_pSnapshot(nullptr), m_Retired() {}
+
+	/** Deletes the snapshots, no reader may be left */
+	~TRcuPointer() {
+		delete m_pSnapshot.load(std::memory_order_relaxed);
+		for (const S * pRetired : m_Retired)
+			delete pRetired;
+	}
+
+	/**
+	 * @return the current snapshot, nullptr if none. Called within a GracePeriod::Reader.
+	 */
+	const S * load() const { return m_pSnapshot.load(std::memory_order_acquire); }
+
+	/**
+	 * Publishes a new snapshot, called by one writer at a time
+	 * @param pSnapshot the new snapshot, owned afterwards
+	 * @return the old snapshot, to be passed to retire()
+	 */
+	const S * exchange(const S * pSnapshot) { return m_pSnapshot.exchange(pSnapshot); }
+
+	/**
+	 * Deletes an old snapshot after the grace period. Deferred if the caller is
+	 * a reader, it is deleted by the next retire() of a non-reader then.
+	 * @param pOld the snapshot returned by exchange(), may be nullptr
+	 * @return true if the grace period has passed
+	 */
+	bool retire(const S * pOld) {
+		if (!m_Grace.synchronize()) {
+			if (pOld != nullptr) {
+				std::lock_guard<std::mutex> lock(m_RetiredMutex);
+				m_Retired.push_back(pOld);
+				}
+			return false;
+			}
+		std::vector<const S *> retired;
+		{
+			std::lock_guard<std::mutex> lock(m_RetiredMutex);
+			retired.swap(m_Retired);
+		}
+		for (const S * pRetired : retired)
+			delete pRetired;
+		delete pOld;
+		return true;
+	}
+
+private:
+	TRcuPointer(const TRcuPointer &);
+	TRcuPointer & operator=(const TRcuPointer &);
+
+	GracePeriod &           m_Grace;
+	std::atomic<const S *>  m_pSnapshot;
+	std::mutex              m_RetiredMutex;
+	std::vector<const S *>  m_Retired;      // Retired by readers, guarded by m_RetiredMutex
+}; // End of template <class S> TRcuPointer
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_GRACEPERIOD_H_*/
@@ -0,0 +1,184 @@
+#ifndef _DE_BSWALZ_MVC_JOURNAL_H_
+#define _DE_BSWALZ_MVC_JOURNAL_H_
+
+/**
+ * Journal class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of TJournal
+ * -------------------------------------------------------------------------
+ *	// At start-up: the last 256 values of the parameter are kept
+ *	m_pGainParameter->enableJournal(256);
+ *
+ *	// A recovering consumer subscribes first and replays the history it missed
+ *	unsigned int id = m_pGainParameter->subscribe(callback);
+ *	std::vector<mvc::TJournal<int>::Entry> entries;
+ *	if (!m_pGainParameter->getJournal()->replay(lastSeenEpoch, entries))
+ *		resynchronize(); // The journal has been overwritten since lastSeenEpoch
+ *	for (auto & entry : entries) apply(entry.m_Epoch, entry.m_Value);
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+/**
+ * Template class TJournal, a fixed-size ring of the recent values of a TModel<T>.<br>
+ * The model records every notified value with its epoch and time, the oldest entry
+ * is overwritten when the ring is full. Readers replay the ring without any lock,
+ * neither the model's nor the journal's: every slot is guarded by a sequence
+ * number, a slot overwritten while being read is detected and reported as a gap.<br>
+ * Values are copied bytewise, hence T has to be trivially copyable.
+ * @see TModel<T>::enableJournal()
+ */
+template <typename T> class TJournal {
+public:
+	/** A recorded value */
+	struct Entry {
+		uint64_t                              m_Epoch;  // Model::getEpoch() of the value
+		std::chrono::steady_clock::time_point m_Time;   // Time of notification
+		T                                     m_Value;
+	};
+
+	/**
+	 * @param capacity the number of entries, rounded up to a power of two
+	 */
+	explicit TJournal(size_t capacity);
+	virtual ~TJournal() {}
+
+	/**
+	 * Records a value, overwriting the oldest entry if the ring is full.<br>
+	 * Called by the model only, with locked model, hence there is a single writer.
+	 * @param epoch the epoch of the value
+	 * @param value the value
+	 */
+	void record(uint64_t epoch, const T & value);
+
+	/**
+	 * Collects the entries recorded after an epoch, oldest first. Called by any thread.
+	 * @param fromEpoch the last epoch already known to the caller, 0 for the whole journal
+	 * @param entries receives the entries with an epoch above fromEpoch
+	 * @return false if entries after fromEpoch have already been overwritten
+	 */
+	bool replay(uint64_t fromEpoch, std::vector<Entry> & entries) const;
+
+	/** @return the number of entries the journal keeps */
+	size_t getCapacity() const { return m_Mask + 1; }
+
+	/** @return the number of values recorded since construction */
+	uint64_t getRecordCount() const { return m_Head.load(std::memory_order_acquire); }
+
+private:
+	TJournal(const TJournal &);
+	TJournal & operator=(const TJournal &);
+
+	struct Slot {
+		std::atomic<uint64_t> m_Sequence;  // Odd while written, 2 * (lap + 1) when holding an entry
+		Entry                 m_Entry;
+	};
+
+	/** Reads the record with the running number index, false if it has been overwritten */
+	bool read(uint64_t index, Entry & entry) const;
+
+	std::unique_ptr<Slot[]> m_upSlots;
+	size_t                  m_Mask;
+	size_t                  m_Shift;   // log2 of the capacity
+	std::atomic<uint64_t>   m_Head;    // Running number of the next record
+}; // End of template <class T> TJournal
+
+
+// -------------------------------------------------------
+// Template class TJournal<T>
+// -------------------------------------------------------
+template <typename T>
+TJournal<T>::TJournal(size_t capacity)
+	: m_upSlots(), m_Mask(0), m_Shift(0), m_Head(0) {
+	static_assert(std::is_trivially_copyable<T>::value, "de::bswalz::mvc::TJournal: T has to be trivially copyable");
+	size_t size = 1;
+	while (size < capacity) {
+		size <<= 1;
+		m_Shift++;
+		}
+	m_Mask = size - 1;
+	m_upSlots.reset(new Slot[size]);
+	for (size_t i = 0; i < size; i++) {
+		m_upSlots[i].m_Sequence.store(0, std::memory_order_relaxed);
+		}
+};
+
+// -------------------------------------------------------
+template <typename T>
+void TJournal<T>::record(uint64_t epoch, const T & value) {
+	const uint64_t head = m_Head.load(std::memory_order_relaxed);
+	Slot & slot = m_upSlots[head & m_Mask];
+	Entry entry{ epoch, std::chrono::steady_clock::now(), value };
+	slot.m_Sequence.store(2 * (head >> m_Shift) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(static_cast<void *>(&slot.m_Entry), &entry, sizeof(Entry));
+	slot.m_Sequence.store(2 * (head >> m_Shift) + 2, std::memory_order_release);
+	m_Head.store(head + 1, std::memory_order_release);
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TJournal<T>::read(uint64_t index, Entry & entry) const {
+	const Slot & slot = m_upSlots[index & m_Mask];
+	const uint64_t sequence = 2 * (index >> m_Shift) + 2;
+	if (slot.m_Sequence.load(std::memory_order_acquire) != sequence)
+		return false;
+	std::memcpy(static_cast<void *>(&entry), &slot.m_Entry, sizeof(Entry));
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return slot.m_Sequence.load(std::memory_order_relaxed) == sequence;
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TJournal<T>::replay(uint64_t fromEpoch, std::vector<Entry> & entries) const {
+	entries.clear();
+	const uint64_t head  = m_Head.load(std::memory_order_acquire);
+	const uint64_t first = (head > m_Mask + 1) ? head - (m_Mask + 1) : 0;
+	// Complete if nothing has been overwritten, or an entry up to fromEpoch precedes the collected ones
+	bool complete = (first == 0);
+	Entry entry;
+	for (uint64_t index = first; index < head; index++) {
+		if (!read(index, entry))
+			complete = false;  // Overwritten by a newer record meanwhile
+		else if (entry.m_Epoch <= fromEpoch)
+			complete = true;
+		else
+			entries.push_back(entry);
+		}
+	return complete;
+};
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_JOURNAL_H_*/
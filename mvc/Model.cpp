@@ -27,91 +27,205 @@
 
 #include "Model.h"
 #include "View.h"
+#include "Anchor.h"
+#include "Dispatcher.h"
+#include "Executor.h"
+#include "FanOutPool.h"
+#include "Notification.h"
+#include "Registry.h"
+#include "Statistics.h"
 #include "../sync/Synchronized.h"
+#include <algorithm>
+#include <cstdlib>
 
-#if defined(WIN32) || defined(__WIN32__)
-#include <process.h>
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Updates a view, measured if the statistics are compiled in
+void Model::deliverUpdate(View * pView, const Model * pModel, void * pObject) {
+	GracePeriod::Scope scope;
+#ifdef DE_BSWALZ_MVC_STATISTICS
+	const auto start = std::chrono::steady_clock::now();
+	pView->update(pModel, pObject);
+	const auto duration = std::chrono::steady_clock::now() - start;
+	Statistics::getInstance()->addUpdate(pView, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
 #else
-#include <unistd.h>
+	pView->update(pModel, pObject);
 #endif
+}
 
-namespace de { namespace bswalz { namespace mvc {
-
-struct NotificationObject { Model * m_pModel; void * m_pObject; };
+// -------------------------------------------------------
+// Updates a view directly or by the executor of the view
+void Model::updateView(View * pView, const void * pSource, const Model * pModel, void * pObject) {
+	if (pView->getExecutor() != nullptr)
+		pView->execute(pSource, pModel, pObject);
+	else
+		deliverUpdate(pView, pModel, pObject);
+}
 
+// -------------------------------------------------------
+// Returns a notification record and its reference to the anchor of the model
+static inline void releaseNotification(NotificationObject * pNO) {
+	pNO->m_pAnchor->release();
+	NotificationPool::getInstance()->release(pNO);
+}
 
 // -------------------------------------------------------
 // Class mvc::Model
 // -------------------------------------------------------
 Model::Model(const std::string & name)
-	: m_Name(name), m_Changed(false), m_SyncMode(true)
+	: m_Name(name), m_Changed(false), m_pTransaction(nullptr), m_SyncMode(true), m_CoalescingMode(false), m_FanOutThreshold(0),
+	  m_pPendingNotification(nullptr), m_pAnchor(nullptr), m_Rank(0), m_InRuleGraph(false), m_ReachesFanIn(false), m_pRegistryNode(nullptr), m_Epoch(0), m_Revision(0),
+	  m_RegisteredViews(m_Grace), m_pStatistics(nullptr)
 { /* Intentionally left blank */ }
 
 // -------------------------------------------------------
 Model::~Model() {
-	m_RegisteredViews.clear();
+	cancelNotifications();
+	if (m_InRuleGraph)
+		RuleGraph::getInstance()->removeModel(this);
+	if (m_pRegistryNode.load(std::memory_order_relaxed) != nullptr)
+		Registry::getInstance()->remove(this);
+#ifdef DE_BSWALZ_MVC_STATISTICS
+	Statistics::getInstance()->removeModel(this);
+#endif
+	// The snapshot is deleted by m_RegisteredViews, no view is updated anymore
+}
+
+// -------------------------------------------------------
+void Model::cancelNotifications() {
+	// Set by the first notification in non-synchronized mode, which must not race with the destructor
+	if (m_pAnchor == nullptr)
+		return;
+	UpdateManager::getInstance()->removeModel(this);
+	m_pAnchor->detach();
+	m_pAnchor = nullptr;
 }
 
 // -------------------------------------------------------
 void Model::registerView(View * pView, bool initialUpdate /* = false */) {
+	const ViewSet * pOldViews = nullptr;
 	synchronized(m_Mutex) {
-		m_RegisteredViews.insert(pView);
+		ViewSet * pViews = new ViewSet();
+		const ViewSet * pCurrent = m_RegisteredViews.load();
+		if (pCurrent != nullptr) {
+			pViews->reserve(pCurrent->size() + 1);
+			*pViews = *pCurrent;
+			}
+		pViews->insert(pView);
+		pOldViews = m_RegisteredViews.exchange(pViews);
 		}
+	// Readers may still iterate the old snapshot
+	m_RegisteredViews.retire(pOldViews);
 	if (initialUpdate)
 		pView->update(this, nullptr);
 }
 
 // -------------------------------------------------------
 void Model::unregisterView(View * pView) {
+	const ViewSet * pOldViews = nullptr;
 	synchronized(m_Mutex) {
-		for (auto pRegisteredView : m_RegisteredViews) {
-			if ((pRegisteredView) == pView) {
-			   m_RegisteredViews.erase(pRegisteredView);
-			   break;
-			   }
+		const ViewSet * pCurrent = m_RegisteredViews.load();
+		if (pCurrent != nullptr && pCurrent->count(pView) > 0) {
+			ViewSet * pViews = new ViewSet(*pCurrent);
+			pViews->erase(pView);
+			pOldViews = m_RegisteredViews.exchange(pViews);
 			}
 	}
+	// Grace period: no other thread updates the view afterwards, skipped by a reader
+	if (pOldViews != nullptr)
+		m_RegisteredViews.retire(pOldViews);
+}
+
+// -------------------------------------------------------
+// A global counter makes epochs comparable between models
+static std::atomic<uint64_t> s_Epoch(0);
+// Completed modifications, incremented after the new epoch is stored
+static std::atomic<uint64_t> s_ModificationCount(0);
+
+// -------------------------------------------------------
+void Model::stampEpoch() {
+	m_Epoch.store(s_Epoch.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_release);
+	s_ModificationCount.fetch_add(1, std::memory_order_release);
+}
+
+// -------------------------------------------------------
+uint64_t Model::getModificationCount() {
+	return s_ModificationCount.load(std::memory_order_acquire);
 }
 
 // -------------------------------------------------------
 void Model::notifyAll(void * pObject) {
 	if (m_Changed) {
-		NotificationObject * pObj = new NotificationObject();
-		pObj->m_pModel            = this;
-		pObj->m_pObject           = pObject;
-   	  
-		if (!m_SyncMode) {
-#if defined(WIN32) || defined(__WIN32__)
-			::_beginthread(&mvc::Model::_notifyAll, 0, pArgs);
-#else
-			// ToDo: implement for UX/Android etc. on the base of pthread
+#ifdef DE_BSWALZ_MVC_STATISTICS
+		Statistics::getInstance()->addNotification(this);
 #endif
-			// delete the pObj is part of _notifyAll !!
+		recordJournal();
+		if (!m_SyncMode) {
+			UpdateManager::getInstance()->addUpdateNotification(this, pObject);
+			}
+		else {
+			notifySubscribers();
+			updateViews(pObject);
+			updatePrefixViews(pObject);
 			}
-	else {
-		for (auto pView : m_RegisteredViews) {
-			pView->update(this, pObject);
-            } // End for
-		delete pObj;
-		}
    	
-	m_Changed = false;
-	}
+		m_Changed = false;
+		}
 }
 
 // -------------------------------------------------------
-// _notifyAll(..) runs in separate thread !
+// _notifyAll(..) runs in a worker thread of the Dispatcher !
 void Model::_notifyAll(void * pObj) {
 	NotificationObject * pNO = (NotificationObject *)pObj;
-	for (auto pView : pNO->m_pModel->m_RegisteredViews) {
-		pView->update(pNO->m_pModel, pNO->m_pObject);
-		}
-	delete pNO;
-#if defined(WIN32) || defined(__WIN32__)
-	::_endthread();
-#else
-	// ToDo: implement for UX/Android etc. on the base of pthread
+#ifdef DE_BSWALZ_MVC_STATISTICS
+	const auto latency = std::chrono::steady_clock::now() - pNO->m_Enqueued;
+	Statistics::getInstance()->addLatency(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
 #endif
+	pNO->m_pModel->notifySubscribers();
+	pNO->m_pModel->updateViews(pNO->m_pObject);
+	pNO->m_pModel->updatePrefixViews(pNO->m_pObject);
+}
+
+// -------------------------------------------------------
+void Model::updateViews(void * pObject) {
+	// The caller is counted as a reader before the snapshot is loaded, see unregisterView()
+	GracePeriod::Reader reader(m_Grace);
+	const ViewSet * pViews = getRegisteredViews();
+	if (pViews == nullptr)
+		return;
+
+	if (m_FanOutThreshold > 0 && pViews->size() >= m_FanOutThreshold) {
+		// The snapshot is kept by the reader until all chunks are done
+		View * const * ppViews = pViews->begin();
+		FanOutPool::getInstance()->run(pViews->size(), [this, ppViews, pObject](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				updateView(ppViews[i], this, this, pObject);
+				}
+			});
+		}
+	else {
+		for (auto pView : *pViews) {
+			updateView(pView, this, this, pObject);
+			} // End for
+		}
+}
+
+// -------------------------------------------------------
+void Model::updatePrefixViews(void * pObject) {
+	if (!Registry::hasSubscriptions())
+		return;
+	// The caller is counted as a reader before the snapshots are loaded, see Registry::unsubscribe()
+	GracePeriod::Reader reader(Registry::getInstance()->m_Grace);
+	// From the node of the name up to the root, independent of the number of subscriptions
+	for (RegistryNode * pNode = m_pRegistryNode.load(std::memory_order_acquire); pNode != nullptr; pNode = pNode->m_pParent) {
+		const RegistryNode::ViewSet * pViews = pNode->m_Views.load();
+		if (pViews == nullptr)
+			continue;
+		for (auto pView : *pViews) {
+			updateView(pView, pNode, this, pObject);
+			}
+		}
 }
 
 // -------------------------------------------------------
@@ -119,73 +233,315 @@ void Model::setSyncMode(bool syncMode) {
 	m_SyncMode = syncMode;
 }
 
+// -------------------------------------------------------
+void Model::setCoalescingMode(bool coalescingMode) {
+	m_CoalescingMode = coalescingMode;
+}
+
+// -------------------------------------------------------
+void Model::setParallelFanOut(size_t minViews) {
+	m_FanOutThreshold = minViews;
+}
+
+// -------------------------------------------------------
+void Model::setCoalescingWindow(std::chrono::microseconds window) {
+	UpdateManager::getInstance()->setCoalescingWindow(window);
+}
+
+// -------------------------------------------------------
+void Model::setNotificationQueue(size_t capacity, OverflowPolicy policy) {
+	UpdateManager::getInstance()->setCapacity(capacity, policy);
+}
+
+// -------------------------------------------------------
+uint64_t Model::getDroppedNotifications() {
+	return UpdateManager::getInstance()->getDropped();
+}
+
+// -------------------------------------------------------
+uint64_t Model::getMergedNotifications() {
+	return UpdateManager::getInstance()->getMerged();
+}
+
 // -------------------------------------------------------
 // Class mvc::Model::UpdateManager
 // -------------------------------------------------------
-std::unique_ptr<Model::UpdateManager> Model::UpdateManager::m_upInstance = std::unique_ptr<Model::UpdateManager>();
-sync::CMutex                          Model::UpdateManager::m_Mutex      = sync::CMutex();
+Model::UpdateManager *                Model::UpdateManager::m_pInstance    = nullptr;
+std::once_flag                        Model::UpdateManager::m_InstanceFlag;
+thread_local bool                     Model::UpdateManager::m_Delivering = false;
 
 // -------------------------------------------------------
 Model::UpdateManager * Model::UpdateManager::getInstance() {
-	if (Model::UpdateManager::m_upInstance.get() == nullptr)
-		Model::UpdateManager::m_upInstance.reset(new Model::UpdateManager());
-	return Model::UpdateManager::m_upInstance.get();
+	std::call_once(m_InstanceFlag, []() {
+		Model::UpdateManager::m_pInstance = new Model::UpdateManager();
+		// Runs before the destruction of the static objects created so far
+		std::atexit(&Model::UpdateManager::shutdown); });
+	return Model::UpdateManager::m_pInstance;
 }
 
 // -------------------------------------------------------
 Model::UpdateManager::UpdateManager() 
-	: m_Notifications(), m_Started(false) { /* Intentionally left blank */ }
+	: m_Ring(INITIAL_CAPACITY, nullptr), m_Head(0), m_Size(0), m_Capacity(0), m_Policy(BLOCK),
+	  m_Dropped(0), m_Merged(0), m_InFlight(0), m_Bounded(false), m_Started(false), m_Stopped(false),
+	  m_CoalescingWindow(0) {
+	// Intentionally left blank
+}
 
 // -------------------------------------------------------
-void Model::UpdateManager::addUpdateNotification(NotificationObject * pNO) {
-	synchronized (m_Mutex) {
-		m_Notifications.push_back(pNO);
-	}; // End synchronized
-	start();
+// The instance is never destroyed, it remains usable in stopped state.
+void Model::UpdateManager::shutdown() {
+	UpdateManager * pThis = m_pInstance;
+	{
+		std::lock_guard<std::mutex> lock(pThis->m_Mutex);
+		pThis->m_Stopped = true;
+	}
+	pThis->m_Condition.notify_one();
+	pThis->m_NotFull.notify_all();
+	if (pThis->m_Thread.joinable())
+		pThis->m_Thread.join();
+	// Shutdown order: first the manager's thread, then the Dispatcher, which
+	// delivers the notifications already posted. The tasks refer to this manager.
+	Dispatcher::shutdown();
+}
+
+// -------------------------------------------------------
+void Model::UpdateManager::addUpdateNotification(Model * pModel, void * pObject) {
+	bool wasEmpty;
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		if (m_Stopped) {
+			lock.unlock();
+			notifyDirectly(pModel, pObject);
+			return;
+			}
+		if (pModel->m_CoalescingMode && pModel->m_pPendingNotification != nullptr) {
+			// Merges with the pending notification of this model
+			pModel->m_pPendingNotification->m_pObject = pObject;
+			return;
+			}
+		if (m_Capacity > 0 && m_Size >= m_Capacity) {
+			if (m_Policy == MERGE_BY_MODEL && pModel->m_pPendingNotification != nullptr) {
+				pModel->m_pPendingNotification->m_pObject = pObject;
+				m_Merged++;
+				return;
+				}
+			// A thread delivering notifications must not wait for the delivery of notifications
+			if (m_Policy == BLOCK && !m_Delivering && !GracePeriod::isReader()) {
+				m_Condition.notify_one(); // Ends the coalescing window
+				m_NotFull.wait(lock, [this]() { return m_Size < m_Capacity || m_Stopped; });
+				if (m_Stopped) {
+					lock.unlock();
+					notifyDirectly(pModel, pObject);
+					return;
+					}
+				}
+			else if (m_Policy != BLOCK) {
+				NotificationObject * pOldest = pop();
+				if (pOldest->m_pModel != nullptr && pOldest->m_pModel->m_pPendingNotification == pOldest)
+					pOldest->m_pModel->m_pPendingNotification = nullptr;
+				releaseNotification(pOldest);
+				m_Dropped++;
+				}
+			}
+		if (pModel->m_pAnchor == nullptr)
+			pModel->m_pAnchor = new Anchor(pModel);
+		pModel->m_pAnchor->addReference();
+		// release of the pNO is part of deliver() !!
+		NotificationObject * pNO = NotificationPool::getInstance()->acquire();
+		pNO->m_pModel            = pModel;
+		pNO->m_pAnchor           = pModel->m_pAnchor;
+		pNO->m_pObject           = pObject;
+#ifdef DE_BSWALZ_MVC_STATISTICS
+		pNO->m_Enqueued          = std::chrono::steady_clock::now();
+#endif
+		pModel->m_pPendingNotification = pNO;
+		wasEmpty = (m_Size == 0);
+		push(pNO);
+#ifdef DE_BSWALZ_MVC_STATISTICS
+		Statistics::getInstance()->setQueueDepth(m_Size);
+#endif
+		start();
+	}
+	// Only the first notification of a batch wakes up the manager's thread
+	if (wasEmpty)
+		m_Condition.notify_one();
 } 
 
 // -------------------------------------------------------
+// Shutdown: the manager's thread is gone, the notification is delivered by the caller
+void Model::UpdateManager::notifyDirectly(Model * pModel, void * pObject) {
+	pModel->notifySubscribers();
+	pModel->updateViews(pObject);
+	pModel->updatePrefixViews(pObject);
+}
+
+// -------------------------------------------------------
+void Model::UpdateManager::setCoalescingWindow(std::chrono::microseconds window) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_CoalescingWindow = window;
+}
+
+// -------------------------------------------------------
+std::chrono::microseconds Model::UpdateManager::getCoalescingWindow() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_CoalescingWindow;
+}
+
+// -------------------------------------------------------
+void Model::UpdateManager::setCapacity(size_t capacity, OverflowPolicy policy) {
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Capacity = capacity;
+		m_Policy   = policy;
+		m_Bounded.store(capacity > 0, std::memory_order_relaxed);
+		if (capacity > m_Ring.size())
+			resize(capacity);
+	}
+	m_NotFull.notify_all();
+}
+
+// -------------------------------------------------------
+uint64_t Model::UpdateManager::getDropped() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Dropped;
+}
+
+// -------------------------------------------------------
+uint64_t Model::UpdateManager::getMerged() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Merged;
+}
+
+// -------------------------------------------------------
+// deliver() runs in a worker thread of the Dispatcher !
+void Model::UpdateManager::deliver(NotificationObject * pNO) {
+	sync::CMutex & anchorMutex = pNO->m_pAnchor->getMutex();
+	synchronized(anchorMutex) {
+		// Discarded if the model has been deleted meanwhile, otherwise its destructor waits
+		if (pNO->m_pModel != nullptr && pNO->m_pAnchor->getOwner() != nullptr) {
+			const bool delivering = m_Delivering;
+			m_Delivering = true;
+			Model::_notifyAll(pNO);
+			m_Delivering = delivering;
+			}
+		}
+	releaseNotification(pNO);
+	m_InFlight.fetch_sub(1, std::memory_order_acq_rel);
+	if (m_Bounded.load(std::memory_order_relaxed)) {
+		// The manager may wait for deliveries
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Condition.notify_one();
+		}
+}
+
+// -------------------------------------------------------
+// removeModel() is called by the destructor of a model. The queued notifications
+// of the model remain in the ring and are discarded by deliver().
+void Model::UpdateManager::removeModel(Model * pModel) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (size_t i = 0; i < m_Size; i++) {
+		NotificationObject * pNO = m_Ring[(m_Head + i) % m_Ring.size()];
+		if (pNO->m_pModel == pModel)
+			pNO->m_pModel = nullptr;
+		}
+	pModel->m_pPendingNotification = nullptr;
+}
+
+// -------------------------------------------------------
+// push() is called with locked m_Mutex. An unbounded ring grows if necessary.
+void Model::UpdateManager::push(NotificationObject * pNO) {
+	if (m_Size == m_Ring.size())
+		resize(2 * m_Ring.size());
+	m_Ring[(m_Head + m_Size) % m_Ring.size()] = pNO;
+	m_Size++;
+}
+
+// -------------------------------------------------------
+// pop() is called with locked m_Mutex and a non-empty ring.
+NotificationObject * Model::UpdateManager::pop() {
+	NotificationObject * pNO = m_Ring[m_Head];
+	m_Head = (m_Head + 1) % m_Ring.size();
+	m_Size--;
+	return pNO;
+}
+
+// -------------------------------------------------------
+// resize() is called with locked m_Mutex, the queued notifications start at index 0 afterwards.
+void Model::UpdateManager::resize(size_t size) {
+	std::vector<NotificationObject *> ring(size, nullptr);
+	for (size_t i = 0; i < m_Size; i++) {
+		ring[i] = m_Ring[(m_Head + i) % m_Ring.size()];
+		}
+	m_Ring.swap(ring);
+	m_Head = 0;
+}
+
+// -------------------------------------------------------
+// start() is called with locked m_Mutex.
 void Model::UpdateManager::start() {
 	if (!m_Started) {
 		m_Started = true;
-#if defined(WIN32) || defined(__WIN32__)
-		::_beginthread(&mvc::Model::UpdateManager::run, 0, nullptr);
-#else
-		// ToDo: implement for UX/Android etc.
-#endif
-	}
+		m_Thread  = std::thread(&Model::UpdateManager::run, this);
+		}
 }
 
 // -------------------------------------------------------
 // run() runs in separate thread.
-void Model::UpdateManager::run(void * pObject) {
-	Model::UpdateManager * pMgr = Model::UpdateManager::getInstance();
-#if defined(WIN32) || defined(__WIN32__)
-	::Sleep(200);	// Suspends the current thread for 200 ms.
-					// In the meantime it's possible to add update notifications.
-#else
-	usleep(2000000); // Suspends the current thread for 200 ms.
-					 // In the meantime it's possible to add update notifications.
-#endif
+void Model::UpdateManager::run() {
+	// The batch keeps its capacity, no heap allocation once it is warm
+	std::vector<NotificationObject *> batch;
+	batch.reserve(INITIAL_CAPACITY);
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	for (;;) {
+		// A bounded queue waits for the delivery of the notifications posted before
+		m_Condition.wait(lock, [this]() { return m_Stopped
+			|| (m_Size > 0 && (m_Capacity == 0 || m_InFlight.load(std::memory_order_acquire) < m_Capacity)); });
+		if (m_Size == 0)
+			break; // Stopped and all notifications are delivered
 
-	synchronized (m_Mutex) {
-	for (unsigned int i = 0; i < pMgr->m_Notifications.size(); i++) {
-		// Notifies all registered listeners of the specified model
-		NotificationObject * pNO = pMgr->m_Notifications[i];
-		for (auto pView : pNO->m_pModel->m_RegisteredViews) {
-			pView->update(pNO->m_pModel, pNO->m_pObject);
-			} // End for
-		delete pNO;
-		} // End for
-	pMgr->m_Notifications.clear();
-	}; // End synchronized
-
-	pMgr->m_Started = false;
-#if defined(WIN32) || defined(__WIN32__)
-	::_endthread();
-#else
-	// ToDo: implement for UX/Android etc.
+		if (m_CoalescingWindow.count() > 0 && !m_Stopped) {
+			// In the meantime it's possible to add update notifications, a full queue ends the window.
+			const auto deadline = std::chrono::steady_clock::now() + m_CoalescingWindow;
+			m_Condition.wait_until(lock, deadline, [this]() {
+				return m_Stopped || (m_Capacity > 0 && m_Size >= m_Capacity); });
+			}
+
+		size_t count = m_Size;
+		if (m_Capacity > 0 && !m_Stopped) {
+			const size_t inFlight = m_InFlight.load(std::memory_order_acquire);
+			count = std::min(count, (inFlight < m_Capacity) ? m_Capacity - inFlight : 0);
+			}
+		while (count-- > 0) {
+			batch.push_back(pop());
+			}
+		m_InFlight.fetch_add(batch.size(), std::memory_order_acq_rel);
+		m_NotFull.notify_all();
+#ifdef DE_BSWALZ_MVC_STATISTICS
+		Statistics::getInstance()->setQueueDepth(m_Size); // Left over if the Dispatcher is saturated
 #endif
+		for (auto pNO : batch) {
+			// Subsequent notifications start a new batch
+			if (pNO->m_pModel != nullptr)
+				pNO->m_pModel->m_pPendingNotification = nullptr;
+			}
+		const bool stopped = m_Stopped;
+		lock.unlock();
+		// The Dispatcher is shut down after this thread, see UpdateManager::shutdown()
+		Dispatcher * pDispatcher = stopped ? nullptr : Dispatcher::getInstance();
+		for (auto pNO : batch) {
+			if (pDispatcher == nullptr) {
+				// Shutdown: delivered by this thread
+				deliver(pNO);
+				}
+			else {
+				// release of the pNO is part of deliver() !!
+				// The anchor is the key of the model, even if the model has been deleted
+				pDispatcher->post(pNO->m_pAnchor, [this, pNO]() { deliver(pNO); });
+				}
+			} // End for
+		batch.clear();
+		lock.lock();
+		}
 }
 
 
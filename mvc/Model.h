@@ -28,16 +28,38 @@
  */
 
 #include "Rules.h"
+#include "Transaction.h"
+#include "RuleGraph.h"
+#include "Journal.h"
+#include "GracePeriod.h"
+#include <atomic>
+#include <cstdint>
 #include "../sync/Synchronized.h"
+#include "../sync/SeqLock.h"
+#include "../FlatSet.h"
+#include "../InplaceFunction.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 #include <memory>
-#include <set>
+#include <optional>
 
 namespace de { namespace bswalz { namespace mvc {
 
 class  View;
+class  IExecutor;
+class  Anchor;
+struct ModelStatistics;
 struct NotificationObject;
+struct RegistryNode;
+#if defined(__cpp_impl_coroutine)
+template <typename T> class TChanges;
+#endif
 
 /**
  * The general Model class of the Model-View-Controller pattern.
@@ -46,8 +68,22 @@ struct NotificationObject;
 class Model {
 
 friend class View;
+friend class Transaction;
+friend class RuleGraph;
+friend class Registry;
+friend class Statistics;
 
 public:
+	/** The behaviour of a full notification queue, see setNotificationQueue() */
+	enum OverflowPolicy {
+		BLOCK,          // The notifying thread waits for free space
+		DROP_OLDEST,    // The oldest queued notification is discarded
+		MERGE_BY_MODEL  // Merged with a queued notification of the same model, otherwise DROP_OLDEST
+	};
+
+	/** The registered views, most models have up to 4 views */
+	typedef de::bswalz::flat_set<mvc::View *, 4> ViewSet;
+
 	Model(const std::string & name);
 	Model(const std::string & name, bool syncMode);
 	virtual ~Model();
@@ -59,32 +95,123 @@ public:
 	
 	/**
 	 * Sets the 'synchronized mode' for notifications.<br>
-	 * If non-synchronized mode is set, all update notifications will run in an extra thread.<br>
+	 * If non-synchronized mode is set, all update notifications will run in a worker thread
+	 * of the mvc::Dispatcher.<br>
 	 * The default value is 'true'.
 	 */
 	void setSyncMode(bool syncMode);
+
+	/**
+	 * Sets the coalescing window of the non-synchronized mode.<br>
+	 * The first queued notification is delivered after this window, all notifications
+	 * queued in the meantime are delivered in the same batch. A window of 0 delivers
+	 * immediately. The default value is 0.
+	 * @param window the coalescing window
+	 */
+	static void setCoalescingWindow(std::chrono::microseconds window);
+
+	/**
+	 * Bounds the queue of notifications in non-synchronized mode.<br>
+	 * At most 'capacity' notifications are queued and at most 'capacity' are
+	 * handed over to the mvc::Dispatcher but not yet delivered. If views fall
+	 * behind, a full queue applies the overflow policy instead of growing.
+	 * A view notifying within its update(), in whichever thread it is updated,
+	 * and a subscriber notifying within a delivery of the mvc::Dispatcher are
+	 * never blocked, they exceed the capacity instead. The default is an unbounded queue.
+	 * @param capacity the maximum number of queued notifications, 0 for unbounded
+	 * @param policy the behaviour of a full queue
+	 */
+	static void setNotificationQueue(size_t capacity, OverflowPolicy policy = BLOCK);
+
+	/**
+	 * @return the number of notifications discarded by a full queue
+	 */
+	static uint64_t getDroppedNotifications();
+
+	/**
+	 * @return the number of notifications merged by a full queue (policy MERGE_BY_MODEL)
+	 */
+	static uint64_t getMergedNotifications();
+
+	/**
+	 * Sets the 'coalescing mode' for notifications in non-synchronized mode.<br>
+	 * If set, a pending notification of this model is merged with subsequent
+	 * notifications (the last associated object wins), hence every view receives
+	 * at most one update per batch of the UpdateManager.<br>
+	 * The default value is 'false'.
+	 */
+	void setCoalescingMode(bool coalescingMode);
+
+	/**
+	 * Enables the parallel update of the registered views by the mvc::FanOutPool,
+	 * if at least minViews views are registered. The notification returns after
+	 * all views have been updated.<br>
+	 * The views have to be thread-safe, the order of their updates is unspecified.
+	 * @param minViews the minimum number of views for a parallel update, 0 disables (default)
+	 */
+	void setParallelFanOut(size_t minViews);
 	
 	/**
 	 * @return the model's mutex
 	 */
 	sync::CMutex & getMutex() { return m_Mutex; }
 
+	/**
+	 * @return the epoch of the last modification of the value. Epochs are
+	 * unique and increase monotonically over all models.
+	 */
+	uint64_t getEpoch() const { return m_Epoch.load(std::memory_order_acquire); }
+
+	/**
+	 * @return the revision of the value, advanced by every write of the value,
+	 * also by a tentative one which is rejected or reverted afterwards. Used by
+	 * IVoter, which votes on tentative values.
+	 */
+	uint64_t getRevision() const { return m_Revision.load(std::memory_order_acquire); }
+
+	/**
+	 * @return the number of completed modifications of all models. A model stamped
+	 * with a new epoch is counted after the epoch is visible by getEpoch().
+	 * @see ChangeTracker
+	 */
+	static uint64_t getModificationCount();
+
+	/**
+	 * Reverts a previous assignment of a value. Does nothing if the model is
+	 * assigned by the open mvc::Transaction of another thread.
+	 */
+	virtual void revertAssignment() {}
+
+	/**
+	 * Validates the assignment using the Voters and AssignRules
+	 */
+	virtual bool validateAssignment() { return true; }
+
 protected:
     /**
-	 * Registers a subsequent view to the list of already existing views.
+	 * Registers a subsequent view to the list of already existing views.<br>
+	 * The previous snapshot of the views is deleted after the grace period,
+	 * see unregisterView().
 	 * @param pView the subsequent view
 	 * @param initialUpdate if false suppresses update notification at registration
      */
 	void registerView(mvc::View * pView, bool initialUpdate = false);
     
     /**
-	 * Unregisters a view from the list of registered views
+	 * Unregisters a view from the list of registered views.<br>
+	 * Waits until no other thread updates the view by a notification of this model
+	 * (grace period), hence the view may be destroyed afterwards. Called within
+	 * the update of a view the grace period is skipped, since the caller is a
+	 * reader itself: views unregistered there must be quiesced by the application.
+	 * Must not be called while holding a lock taken by update().
      * @param pView the view to be unregistered
      */
     void unregisterView(mvc::View * pView);
 
 protected:
-	Model() {}	
+	Model() : m_Changed(false), m_pTransaction(nullptr), m_SyncMode(true), m_CoalescingMode(false), m_FanOutThreshold(0),
+	          m_pPendingNotification(nullptr), m_pAnchor(nullptr), m_Rank(0), m_InRuleGraph(false), m_ReachesFanIn(false), m_pRegistryNode(nullptr), m_Epoch(0), m_Revision(0),
+	          m_RegisteredViews(m_Grace), m_pStatistics(nullptr) {}
 
     /**
 	 * Indicates the model as 'changed'
@@ -95,7 +222,49 @@ protected:
 	 * @return true if model has changed.
      */
     bool hasChanged() { return m_Changed; };
+
+    /**
+	 * @return false if the model has been assigned by an open mvc::Transaction other
+	 * than pTransaction. Called with locked m_Mutex.
+	 * @param pTransaction the transaction of the caller, nullptr if none
+     */
+    bool isAssignable(const Transaction * pTransaction) const { return m_pTransaction == nullptr || m_pTransaction == pTransaction; }
+
+    /**
+	 * Stamps the model with a new epoch. Called once a modification has been
+	 * validated and actually changes the value, never for a reverted one.
+	 * @see getEpoch()
+     */
+    void stampEpoch();
+
+    /**
+	 * Advances the revision, called after every write of the value
+	 * @see getRevision()
+     */
+    void advanceRevision() { m_Revision.fetch_add(1, std::memory_order_release); }
     
+    /**
+	 * Applies the AssignRules of this model
+	 */
+	virtual void applyAssignRules() {}
+
+    /**
+	 * Accepts the assigned value as the value to revert to
+	 */
+	virtual void commitAssignment() {}
+
+    /**
+	 * Delivers the current value to the typed subscriptions of TModel<T>.
+	 * Called by the notification before the registered views are updated.
+     */
+	virtual void notifySubscribers() {}
+
+    /**
+	 * Records the current value in the journal of TModel<T>, if enabled.
+	 * Called by notifyAll() in the modifying thread, once per notified modification.
+     */
+	virtual void recordJournal() {}
+
     /**
 	 * Notifies all registered views.
 	 * @see setSyncMode(bool)
@@ -103,36 +272,121 @@ protected:
      */
 	void notifyAll(void * pObject = nullptr);
 
+    /**
+	 * Discards the queued notifications of this model in non-synchronized mode and
+	 * waits for a delivery running in another thread. Called by the destructors of
+	 * Model and TModel<T>; a derived class whose members are read by the views
+	 * calls it first in its destructor. Repeated calls do nothing.<br>
+	 * A model must not be deleted by the update of its own views.
+     */
+	void cancelNotifications();
+
     sync::CMutex           m_Mutex;
+    GracePeriod            m_Grace;                // Readers of the snapshots of this model and of TModel<T>
 	
 private:
     std::string            m_Name;
-    bool                   m_Changed;
+    std::atomic<bool>      m_Changed;              // Set by the assignments, cleared by notifyAll()
+    Transaction *          m_pTransaction;         // Open transaction which has assigned the model, guarded by m_Mutex
     bool                   m_SyncMode;
-    std::set<mvc::View *>  m_RegisteredViews;
-#if defined(WIN32) || defined(__WIN32__)
-	static  void __cdecl   _notifyAll(void *);
-#else
+    bool                   m_CoalescingMode;
+    size_t                 m_FanOutThreshold;      // 0 if disabled
+    NotificationObject *   m_pPendingNotification; // Latest queued, guarded by UpdateManager
+    Anchor *               m_pAnchor;              // Created by the first queued notification, guarded by UpdateManager
+    std::atomic<unsigned int> m_Rank;              // Guarded by RuleGraph
+    bool                   m_InRuleGraph;
+    std::atomic<bool>      m_ReachesFanIn;         // See RuleGraph::reachesFanIn()
+    std::atomic<RegistryNode *> m_pRegistryNode;   // Node of the name, nullptr if not registered
+    std::atomic<uint64_t>  m_Epoch;                // Stamped by accepted changes only
+    std::atomic<uint64_t>  m_Revision;             // Advanced by every write of the value
+    TRcuPointer<ViewSet>   m_RegisteredViews;      // Copy-on-write, see getRegisteredViews()
+    mutable std::atomic<ModelStatistics *> m_pStatistics; // Attached by the first notification, see Statistics
 	static  void           _notifyAll(void *);
-#endif
+
+    /**
+	 * Calls View::update(), measured if the statistics are compiled in.
+	 * Called by the notifying thread or by the executor of the view.
+	 * @param pView the view
+	 * @param pModel the notifying model
+	 * @param pObject an associated object
+     */
+	static void deliverUpdate(View * pView, const Model * pModel, void * pObject);
+
+    /**
+	 * Updates a view directly or by the executor of the view
+	 * @param pView the view
+	 * @param pSource the key of the registration, the model or the mvc::RegistryNode of a prefix
+	 * @param pModel the notifying model
+	 * @param pObject an associated object
+     */
+	static void updateView(View * pView, const void * pSource, const Model * pModel, void * pObject);
+
+    /**
+	 * Updates the registered views, in parallel if enabled by setParallelFanOut()
+	 * @param pObject an associated object
+     */
+	void updateViews(void * pObject);
+
+    /**
+	 * Updates the views subscribed to a prefix of the name, see Registry::subscribe()
+	 * @param pObject an associated object
+     */
+	void updatePrefixViews(void * pObject);
+
+    /**
+	 * @return an immutable snapshot of the registered views, nullptr if none. Iterating
+	 * the snapshot requires no lock, registerView() and unregisterView() publish a new
+	 * snapshot. Called within a GracePeriod::Reader of m_Grace, which keeps the snapshot.
+     */
+	const ViewSet * getRegisteredViews() const { return m_RegisteredViews.load(); }
 
 private:
     /* 
-	 * Nested class UpdateManager which handles update notifications in non-synchronized mode
+	 * Nested class UpdateManager which handles update notifications in non-synchronized mode.<br>
+	 * The manager's thread wakes up at the first queued notification, waits for the
+	 * coalescing window and hands over the whole batch to the mvc::Dispatcher.
      */
     class UpdateManager {
     public:
        static UpdateManager * getInstance();
-	   void        addUpdateNotification(NotificationObject *);
-       virtual     ~UpdateManager() {};
+	   void        addUpdateNotification(Model * pModel, void * pObject);
+	   void        setCoalescingWindow(std::chrono::microseconds window);
+	   std::chrono::microseconds getCoalescingWindow();
+	   void        setCapacity(size_t capacity, OverflowPolicy policy);
+	   uint64_t    getDropped();
+	   uint64_t    getMerged();
+	   void        deliver(NotificationObject * pNO);
+	   void        removeModel(Model * pModel);
+	   static void shutdown();
     private:
        UpdateManager();
+       ~UpdateManager();
        void        start();
-       static void run(void *);
-	   static std::unique_ptr<Model::UpdateManager> m_upInstance;
-	   std::vector<NotificationObject *>  m_Notifications;
+       void        run();
+	   void        notifyDirectly(Model * pModel, void * pObject);
+	   void        push(NotificationObject * pNO);
+	   NotificationObject * pop();
+	   void        resize(size_t size);
+	   static const size_t INITIAL_CAPACITY = 256;
+	   static Model::UpdateManager *    m_pInstance;      // Not destroyed at exit, see shutdown()
+	   static std::once_flag            m_InstanceFlag;
+	   std::vector<NotificationObject *>  m_Ring;        // Queued notifications, m_Size from m_Head on
+	   size_t                           m_Head;
+	   size_t                           m_Size;
+	   size_t                           m_Capacity;       // 0 if unbounded
+	   OverflowPolicy                   m_Policy;
+	   uint64_t                         m_Dropped;
+	   uint64_t                         m_Merged;
+	   std::atomic<size_t>              m_InFlight;       // Posted to the Dispatcher, not yet delivered
+	   std::atomic<bool>                m_Bounded;
+	   static thread_local bool         m_Delivering;     // True within deliver()
        bool                             m_Started;
-       static sync::CMutex              m_Mutex;
+       bool                             m_Stopped;
+       std::chrono::microseconds        m_CoalescingWindow;
+       std::thread                      m_Thread;
+       std::mutex                       m_Mutex;
+       std::condition_variable          m_Condition;
+       std::condition_variable          m_NotFull;        // Policy BLOCK
     }; // End of nested class Model::UpdateManager    
     
 }; // End of class Model
@@ -150,24 +404,37 @@ public:
 	 * Assigns a value to the model
 	 * @param value the new value
 	 * @param pRule the instance of assign rule
-	 * @return true if the assignment has been successfully performed
+	 * @return true if the assignment has been successfully performed. False if the
+	 * validation failed, if the model is assigned by an open mvc::Transaction of
+	 * another thread, or if the previous assignment is being notified (e.g. an
+	 * assignment by a view of this model); the value is not assigned then.
 	 */
 	virtual bool assignValue(const T & value, const IAssignRule* pRule = nullptr);
 
 	/**
-	 * Reverts a previous assignment of a value
+	 * Reverts a previous assignment of a value. Does nothing if the model is
+	 * assigned by the open mvc::Transaction of another thread.
 	 */
-	virtual void revertAssignment();
+	virtual void revertAssignment() override;
 
 	/**
 	 * Validates the assignment using the Voters and AssignRules
 	 */
-	virtual bool validateAssignment();
+	virtual bool validateAssignment() override;
 
 	/**
 	 * @return the currently assigned value to this model
 	 */
 	virtual T &  getValue();
+
+	/**
+	 * Reads the value without locking the model, for trivially copyable T only.<br>
+	 * The value is published by every assignment, readers never observe a torn
+	 * value and never touch the model's mutex, see sync::TSeqLock.
+	 * Modifications through the reference of getValue() are not published.
+	 * @return the value of the last assignment
+	 */
+	T load() const;
     
 	/**
 	 * Adds an AssignRule to the list of rules of this model
@@ -184,19 +451,233 @@ public:
 	/** Access to voter */
 	std::shared_ptr<TVoter<T>> getVoter() const { return m_spVoter; }
 
+	/**
+	 * Receives the new and the previously notified value of a subscription
+	 */
+	typedef de::bswalz::inplace_function<void(const T & value, const T & oldValue)> Callback;
+
+	/**
+	 * Subscribes a callback to the modifications of this model.<br>
+	 * The callback is invoked with the new value and the value of the previous
+	 * notification, in the same thread and order as View::update(). Coalesced
+	 * notifications deliver the latest value and the last delivered one.
+	 * @param callback the callback, must fit into the inline storage of Callback
+	 * @param initialUpdate if true invokes the callback at subscription
+	 * @return the id of the subscription
+	 */
+	unsigned int subscribe(Callback callback, bool initialUpdate = false);
+
+	/**
+	 * Decides whether a filtered subscription receives a notification
+	 */
+	typedef de::bswalz::inplace_function<bool(const T & value, const T & lastValue)> Filter;
+
+	/**
+	 * Subscribes a callback which receives only the notifications accepted by a filter.<br>
+	 * The filter is evaluated before dispatch, with locked model, by the new value and
+	 * the value last delivered to this subscription, e.g. for a band boundary:
+	 * [](const int & value, const int & lastValue) { return value / 100 != lastValue / 100; }<br>
+	 * The callback receives the value last delivered to this subscription as oldValue.
+	 * @param callback the callback, must fit into the inline storage of Callback
+	 * @param filter the filter, must fit into the inline storage of Filter
+	 * @param initialUpdate if true invokes the callback at subscription
+	 * @return the id of the subscription
+	 */
+	unsigned int subscribeFiltered(Callback callback, Filter filter, bool initialUpdate = false);
+
+	/**
+	 * @param delta the minimum change of the value
+	 * @return a filter accepting values which differ at least by delta from the last delivered one
+	 */
+	static Filter deadband(const T & delta);
+
+	/**
+	 * Removes a subscription.<br>
+	 * Waits until no other thread invokes the callback (grace period, see
+	 * Model::unregisterView()), hence the objects referred to by the callback may be
+	 * destroyed afterwards. Called within a notification the grace period is skipped.
+	 * @param id the id returned by subscribe()
+	 */
+	void unsubscribe(unsigned int id);
+
+#if defined(__cpp_impl_coroutine)
+	/**
+	 * Creates an awaitable stream of the values of this model for C++20 coroutines,
+	 * e.g. T value = co_await model.changed(&executor);<br>
+	 * Notifications between two awaits coalesce into the latest value.
+	 * @param pExecutor the executor resuming the coroutine, nullptr resumes within the notifying thread
+	 * @param initialUpdate if true the first await returns the current value immediately
+	 * @return the stream, subscribed until its destruction
+	 * @see TChanges
+	 */
+	TChanges<T> changed(IExecutor * pExecutor = nullptr, bool initialUpdate = false);
+#endif
+
+	/**
+	 * Enables the journal of the recent values of this model. Every notified
+	 * value is recorded with its epoch and time, see TJournal.<br>
+	 * T has to be trivially copyable. Enabled once, before the model is shared.
+	 * @param capacity the number of entries kept, rounded up to a power of two
+	 * @throws std::logic_error if the journal is already enabled
+	 */
+	void enableJournal(size_t capacity);
+
+	/**
+	 * @return the journal of this model, nullptr if not enabled
+	 */
+	const TJournal<T> * getJournal() const { return m_pJournal.load(std::memory_order_acquire); }
+
 protected:	
-	TModel() : Model() {}
+	TModel() : Model(), m_Subscriptions(m_Grace), m_NextSubscriptionId(0), m_pJournal(nullptr), m_Published(T()) {}
+
+	virtual void applyAssignRules() override;
+
+	virtual void commitAssignment() override;
+
+	/**
+	 * Stores the value within the open mvc::Transaction of the current thread.<br>
+	 * AssignRules, validation and notification are deferred to Transaction::commit().
+	 * @param value the new value
+	 * @param pRule the instance of assign rule
+	 * @param success set to false if the model is assigned by the transaction of another thread
+	 * @return false if there is no open transaction
+	 */
+	bool deferAssignment(const T & value, const IAssignRule* pRule, bool & success);
 
-	virtual void applyAssignRules();
+	/**
+	 * Performs the assignment as a mvc::Transaction, if a transaction is open or
+	 * if the assignment propagates through AssignRules to a fan-in of the
+	 * mvc::RuleGraph. The propagation then follows the topological order of the graph.
+	 * @param value the new value
+	 * @param pRule the instance of assign rule
+	 * @param success receives the result of the assignment
+	 * @return false if the assignment has to be performed directly
+	 */
+	bool assignTransacted(const T & value, const IAssignRule* pRule, bool & success);
+
+	virtual void notifySubscribers() override;
+
+	virtual void recordJournal() override;
+
+	/**
+	 * Publishes m_Value to load(). Called with locked m_Mutex once the value has
+	 * been validated or reverted, never for a value which may still be rejected.
+	 * Does nothing if T is not trivially copyable.
+	 */
+	void publishValue();
+
+	/**
+	 * Stamps the epoch if the accepted value differs from m_CurrValue, the value
+	 * before the assignment. Called with locked m_Mutex before m_CurrValue is updated.
+	 * @param value the validated value
+	 */
+	void stampIfChanged(const T & value);
 	
     T                             m_Value;
 	T							  m_CurrValue;
     std::vector<TAssignRule<T> *> m_pAssignRules;
 	std::shared_ptr<TVoter<T>>	  m_spVoter;
+
+private:
+	// Compares by operator!= if T has one, otherwise every assignment is a change
+	template <typename U> static auto differs(const U & a, const U & b, int) -> decltype(bool(a != b)) { return a != b; }
+	template <typename U> static bool differs(const U &, const U &, long) { return true; }
+
+	// State of a filtered subscription, shared by the copies of the snapshot
+	struct FilterState {
+		Filter       m_Filter;
+		std::optional<T> m_LastValue; // Last value delivered to the subscription, guarded by m_Mutex
+	};
+	struct Subscription {
+		unsigned int m_Id;
+		Callback     m_Callback;
+		std::shared_ptr<FilterState> m_spFilter; // nullptr if not filtered
+	};
+	typedef std::vector<Subscription> Subscriptions;
+
+	// Filtered subscription accepted by a notification, with the value last delivered to it
+	struct Accepted {
+		const Subscription * m_pSubscription;
+		std::optional<T>     m_LastValue;
+	};
+	static const size_t ACCEPTED_INLINE = 16;   // Accepted subscriptions kept on the stack
+
+	unsigned int addSubscription(const Callback & callback, std::shared_ptr<FilterState> spFilter, bool initialUpdate);
+
+	TRcuPointer<Subscriptions>    m_Subscriptions;  // Copy-on-write like the registered views
+	T                             m_NotifiedValue;  // The oldValue of the next notification
+	unsigned int                  m_NextSubscriptionId;
+	std::atomic<TJournal<T> *>    m_pJournal;       // Owned, nullptr if not enabled
+
+	struct Unpublished { explicit Unpublished(const T &) {} };
+	// The copy of m_Value read by load(), on its own cache line
+	typename std::conditional<std::is_trivially_copyable<T>::value,
+	                          sync::TSeqLock<T>, Unpublished>::type m_Published;
 }; // End of template <class T> Model
+
+
+/**
+ * The typed view of a TModel<T>.<br>
+ * In contrast to View, update() receives the model's value and the value of the
+ * previous notification, without any cast or reading back the model.
+ * The models must outlive the view or the view has to be unregistered.
+ * The destructor unregisters the view and waits for its updates running in other
+ * threads (see TModel<T>::unsubscribe()); a derived class updated by other threads
+ * calls unregisterAt() in its own destructor, before its members are destroyed.<br>
+ * update() is always called by the notifying thread, a TView<T> has no executor
+ * (see View::setExecutor()): a queued update had to carry copies of value and
+ * oldValue, which exceed the inline storage of IExecutor::Task for most T. A view
+ * owned by another thread forwards the values to this thread itself.
+ */
+template <typename T> class TView {
+public:
+	TView() : m_Subscriptions() {}
+	virtual ~TView();
+
+	/**
+	 * Registers this view at the specified model
+	 * @param pModel the model to be registered at
+	 * @param initialUpdate if false suppresses update at registration
+	 */
+	void registerAt(TModel<T> * pModel, bool initialUpdate = false);
+
+	/**
+	 * Registers this view at the specified model, receiving only the notifications
+	 * accepted by the filter
+	 * @param pModel the model to be registered at
+	 * @param filter the filter, e.g. TModel<T>::deadband(delta)
+	 * @param initialUpdate if false suppresses update at registration
+	 * @see TModel<T>::subscribeFiltered()
+	 */
+	void registerFilteredAt(TModel<T> * pModel, typename TModel<T>::Filter filter, bool initialUpdate = false);
+
+	/**
+	 * Unregisters this view at the specified model. Returns after all updates
+	 * of this view by the model running in other threads are done.
+	 * @param pModel the model to be unregistered at
+	 */
+	void unregisterAt(TModel<T> * pModel);
+
+	/**
+	 * Receives an update notification of an associated model
+	 * @param pModel the source model of this notification
+	 * @param value the new value of the model
+	 * @param oldValue the value of the previous notification
+	 */
+	virtual void update(const TModel<T> * pModel, const T & value, const T & oldValue) = 0;
+
+private:
+	TView(const TView &);
+	TView & operator=(const TView &);
+
+	std::vector<std::pair<TModel<T> *, unsigned int> > m_Subscriptions;
+}; // End of template <class T> TView
    
 }}} // End of namespaces
 
 #include "Model.inl"
+#if defined(__cpp_impl_coroutine)
+#include "Changes.h"
+#endif
 
 #endif /*_DE_BSWALZ_MVC_MODEL_H_*/
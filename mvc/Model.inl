@@ -4,52 +4,125 @@
 // -------------------------------------------------------
 template <typename T>
 de::bswalz::mvc::TModel<T>::TModel(std::string name, T value)
-	: Model(name), m_Value(value), m_CurrValue(value), m_spVoter()
+	: Model(name), m_Value(value), m_CurrValue(value), m_spVoter(),
+	  m_Subscriptions(m_Grace), m_NotifiedValue(value), m_NextSubscriptionId(0), m_pJournal(nullptr),
+	  m_Published(value)
 { /* Intentionally left blank */ }; 
 	   
 // -------------------------------------------------------
 template <typename T>
 de::bswalz::mvc::TModel<T>::~TModel() {
+	Model::cancelNotifications();
 	m_pAssignRules.clear();
 	m_spVoter.reset();
+	delete m_pJournal.exchange(nullptr);
 };
 	   
 // -------------------------------------------------------
 template <typename T>
 bool de::bswalz::mvc::TModel<T>::assignValue( const T & value, const IAssignRule* pRule ) {
 	bool success = true;
+	if (assignTransacted(value, pRule, success))
+		return success;
+
 	if (!Model::hasChanged()) {
 		synchronized(m_Mutex) {
-			m_CurrValue = m_Value;
-			m_Value     = value;
-			applyAssignRules();
-			if (pRule == nullptr && !validateAssignment()) {
-				revertAssignment();
-				success = false;
+			if (!Model::isAssignable(nullptr)) {
+				success = false; // Assigned by the open transaction of another thread
 				}
 			else {
-				m_CurrValue = value;
-				setChanged();
+				m_CurrValue = m_Value;
+				m_Value     = value;
+				advanceRevision();
+				applyAssignRules();
+				if (pRule == nullptr && !validateAssignment()) {
+					revertAssignment();
+					success = false;
+					}
+				else {
+					stampIfChanged(value);
+					m_CurrValue = value;
+					publishValue(); // Only a validated value is published
+					setChanged();
+					}
 				}
 			} // End synchronized
 		notifyAll();
 		} // End if hasChanged() == false
+	else {
+		success = false; // Dropped, the previous assignment is being notified
+		}
 	return success;
 };
 
 // -------------------------------------------------------
 template <typename T>
-void de::bswalz::mvc::TModel<T>::revertAssignment() {
-	m_Value = m_CurrValue;
-	for (auto pAssignRule : m_pAssignRules) {
-		pAssignRule->revert();
+bool de::bswalz::mvc::TModel<T>::deferAssignment( const T & value, const IAssignRule* pRule, bool & success ) {
+	Transaction * pTransaction = Transaction::getCurrent();
+	if (pTransaction == nullptr)
+		return false;
+
+	synchronized(m_Mutex) {
+		if (!Model::isAssignable(pTransaction)) {
+			success = false; // Assigned by the open transaction of another thread
+			pTransaction->setRollbackOnly();
+			}
+		else {
+			if (pTransaction->enlist(this, pRule == nullptr))
+				m_CurrValue = m_Value; // The value to revert to
+			m_Value = value;       // Stamped by commitAssignment()
+			advanceRevision();
+			}
+		} // End synchronized
+	return true;
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool de::bswalz::mvc::TModel<T>::assignTransacted( const T & value, const IAssignRule* pRule, bool & success ) {
+	success = true;
+	if (deferAssignment(value, pRule, success))
+		return true; // Validated by Transaction::commit()
+
+	if (pRule == nullptr && !m_pAssignRules.empty() && RuleGraph::reachesFanIn(this) && !Model::hasChanged()) {
+		// Propagates once through the AssignRules in topological order
+		Transaction transaction;
+		bool deferred = true;
+		deferAssignment(value, pRule, deferred);
+		success = transaction.commit() && deferred;
+		return true;
 		}
+	return false;
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TModel<T>::commitAssignment() {
+	stampIfChanged(m_Value);
+	m_CurrValue = m_Value;
+	publishValue();
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TModel<T>::revertAssignment() {
+	synchronized(m_Mutex) {
+		// A target of an AssignRule may hold the value of another thread's open transaction
+		if (Model::isAssignable(Transaction::getCurrent())) {
+			m_Value = m_CurrValue;
+			advanceRevision();
+			publishValue();
+			for (auto pAssignRule : m_pAssignRules) {
+				pAssignRule->revert();
+				}
+			}
+		} // End synchronized
 }
 
 // -------------------------------------------------------
 template <typename T>
 bool de::bswalz::mvc::TModel<T>::validateAssignment() {
-	if (m_spVoter.get() != nullptr && !m_spVoter->vote())
+	if (m_spVoter.get() != nullptr && !m_spVoter->getVote())
 		return false;
 
 	for (auto pAssignRule : m_pAssignRules) {
@@ -66,9 +139,32 @@ T & de::bswalz::mvc::TModel<T>::getValue() {
 	return m_Value;
 };
    
+// -------------------------------------------------------
+template <typename T>
+T de::bswalz::mvc::TModel<T>::load() const {
+	static_assert(std::is_trivially_copyable<T>::value, "de::bswalz::mvc::TModel::load: T has to be trivially copyable");
+	return m_Published.load();
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TModel<T>::publishValue() {
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		m_Published.store(m_Value);
+		}
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TModel<T>::stampIfChanged(const T & value) {
+	if (differs(m_CurrValue, value, 0))
+		stampEpoch();
+};
+
 // -------------------------------------------------------
 template <typename T>
 void de::bswalz::mvc::TModel<T>::addAssignRule(TAssignRule<T> * pRule, bool initialAppl) {
+	RuleGraph::getInstance()->addRule(this, pRule); // Throws if the rule closes a cycle
 	m_pAssignRules.push_back(pRule);
 	if (initialAppl)
 		pRule->apply(this);
@@ -89,3 +185,191 @@ void de::bswalz::mvc::TModel<T>::applyAssignRules() {
 };
 
 	   
+
+// -------------------------------------------------------
+template <typename T>
+unsigned int de::bswalz::mvc::TModel<T>::subscribe(Callback callback, bool initialUpdate) {
+	return addSubscription(callback, std::shared_ptr<FilterState>(), initialUpdate);
+};
+
+// -------------------------------------------------------
+template <typename T>
+unsigned int de::bswalz::mvc::TModel<T>::subscribeFiltered(Callback callback, Filter filter, bool initialUpdate) {
+	std::shared_ptr<FilterState> spFilter = std::make_shared<FilterState>();
+	spFilter->m_Filter = filter;
+	return addSubscription(callback, spFilter, initialUpdate);
+};
+
+// -------------------------------------------------------
+template <typename T>
+typename de::bswalz::mvc::TModel<T>::Filter de::bswalz::mvc::TModel<T>::deadband(const T & delta) {
+	return [delta](const T & value, const T & lastValue) {
+		return (value > lastValue) ? (value - lastValue >= delta) : (lastValue - value >= delta); };
+};
+
+// -------------------------------------------------------
+template <typename T>
+unsigned int de::bswalz::mvc::TModel<T>::addSubscription(const Callback & callback, std::shared_ptr<FilterState> spFilter, bool initialUpdate) {
+	unsigned int id = 0;
+	std::optional<T> value; // T needs no default constructor
+	const Subscriptions * pOldSubscriptions = nullptr;
+	synchronized(m_Mutex) {
+		id = ++m_NextSubscriptionId;
+		Subscriptions * pSubscriptions = new Subscriptions();
+		const Subscriptions * pCurrent = m_Subscriptions.load();
+		if (pCurrent != nullptr) {
+			pSubscriptions->reserve(pCurrent->size() + 1);
+			*pSubscriptions = *pCurrent;
+			}
+		if (pSubscriptions->empty())
+			m_NotifiedValue = m_Value; // The first subscription starts at the current value
+		if (spFilter.get() != nullptr)
+			spFilter->m_LastValue = m_Value;
+		pSubscriptions->push_back(Subscription{ id, callback, spFilter });
+		pOldSubscriptions = m_Subscriptions.exchange(pSubscriptions);
+		if (initialUpdate)
+			value = m_Value;
+		} // End synchronized
+	// Notifications may still iterate the old snapshot
+	m_Subscriptions.retire(pOldSubscriptions);
+	if (initialUpdate)
+		callback(*value, *value);
+	return id;
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TModel<T>::unsubscribe(unsigned int id) {
+	const Subscriptions * pOldSubscriptions = nullptr;
+	synchronized(m_Mutex) {
+		const Subscriptions * pCurrent = m_Subscriptions.load();
+		if (pCurrent != nullptr) {
+			Subscriptions * pSubscriptions = new Subscriptions(*pCurrent);
+			for (auto it = pSubscriptions->begin(); it != pSubscriptions->end(); ++it) {
+				if (it->m_Id == id) {
+					pSubscriptions->erase(it);
+					break;
+					}
+				}
+			pOldSubscriptions = m_Subscriptions.exchange(pSubscriptions);
+			}
+		} // End synchronized
+	// Grace period: no other thread invokes the callback afterwards, skipped by a reader
+	if (pOldSubscriptions != nullptr)
+		m_Subscriptions.retire(pOldSubscriptions);
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TModel<T>::notifySubscribers() {
+	// The caller is counted as a reader before the snapshot is loaded, see unsubscribe()
+	GracePeriod::Reader reader(m_Grace);
+	const Subscriptions * pSubscriptions = m_Subscriptions.load();
+	if (pSubscriptions == nullptr || pSubscriptions->empty())
+		return;
+
+	std::optional<T> value, oldValue; // T needs no default constructor
+	// Accepted filtered subscriptions in order of subscription. The first ACCEPTED_INLINE
+	// are kept on the stack, only more accepted subscriptions at once allocate.
+	Accepted              accepted[ACCEPTED_INLINE];
+	std::vector<Accepted> moreAccepted;
+	size_t                acceptedCount = 0;
+	synchronized(m_Mutex) {
+		value.emplace(m_Value);
+		oldValue.emplace(m_NotifiedValue);
+		m_NotifiedValue = m_Value;
+		for (auto & subscription : *pSubscriptions) {
+			FilterState * pFilter = subscription.m_spFilter.get();
+			if (pFilter != nullptr && pFilter->m_Filter(*value, *pFilter->m_LastValue)) {
+				if (acceptedCount < ACCEPTED_INLINE)
+					accepted[acceptedCount] = Accepted{ &subscription, pFilter->m_LastValue };
+				else
+					moreAccepted.push_back(Accepted{ &subscription, pFilter->m_LastValue });
+				acceptedCount++;
+				pFilter->m_LastValue = *value;
+				}
+			}
+		} // End synchronized
+
+	size_t next = 0; // The next accepted subscription
+	for (auto & subscription : *pSubscriptions) {
+		if (subscription.m_spFilter.get() == nullptr)
+			subscription.m_Callback(*value, *oldValue);
+		else if (next < acceptedCount) {
+			const Accepted & entry = (next < ACCEPTED_INLINE) ? accepted[next] : moreAccepted[next - ACCEPTED_INLINE];
+			if (entry.m_pSubscription == &subscription) {
+				subscription.m_Callback(*value, *entry.m_LastValue);
+				next++;
+				}
+			}
+		}
+};
+
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TModel<T>::enableJournal(size_t capacity) {
+	std::unique_ptr<TJournal<T>> upJournal(new TJournal<T>(capacity));
+	synchronized(m_Mutex) {
+		if (m_pJournal.load(std::memory_order_relaxed) != nullptr)
+			throw std::logic_error("de::bswalz::mvc::TModel::enableJournal: journal of '" + getName() + "' already enabled");
+		m_pJournal.store(upJournal.release(), std::memory_order_release);
+		} // End synchronized
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TModel<T>::recordJournal() {
+	// Instantiated for every T, but a journal is only enabled for trivially copyable T
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		TJournal<T> * pJournal = m_pJournal.load(std::memory_order_acquire);
+		if (pJournal == nullptr)
+			return;
+		synchronized(m_Mutex) {
+			pJournal->record(getEpoch(), m_Value);
+			} // End synchronized
+		}
+};
+
+// -------------------------------------------------------
+// Template class TView<T>
+// -------------------------------------------------------
+template <typename T>
+de::bswalz::mvc::TView<T>::~TView() {
+	for (auto & subscription : m_Subscriptions) {
+		subscription.first->unsubscribe(subscription.second);
+		}
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TView<T>::registerAt(TModel<T> * pModel, bool initialUpdate) {
+	TView<T> * pView = this;
+	unsigned int id  = pModel->subscribe(
+		[pView, pModel](const T & value, const T & oldValue) { pView->update(pModel, value, oldValue); },
+		initialUpdate);
+	m_Subscriptions.push_back(std::make_pair(pModel, id));
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TView<T>::registerFilteredAt(TModel<T> * pModel, typename TModel<T>::Filter filter, bool initialUpdate) {
+	TView<T> * pView = this;
+	unsigned int id  = pModel->subscribeFiltered(
+		[pView, pModel](const T & value, const T & oldValue) { pView->update(pModel, value, oldValue); },
+		filter, initialUpdate);
+	m_Subscriptions.push_back(std::make_pair(pModel, id));
+};
+
+// -------------------------------------------------------
+template <typename T>
+void de::bswalz::mvc::TView<T>::unregisterAt(TModel<T> * pModel) {
+	for (auto it = m_Subscriptions.begin(); it != m_Subscriptions.end(); ) {
+		if (it->first == pModel) {
+			pModel->unsubscribe(it->second);
+			it = m_Subscriptions.erase(it);
+			}
+		else
+			++it;
+		}
+};
@@ -0,0 +1,121 @@
+/**
+ * Notification records of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Notification.h"
+
+namespace de { namespace bswalz { namespace mvc {
+
+// Index of records which do not belong to a chunk of the pool
+static const uint32_t UNPOOLED = 0xFFFFFFFFu;
+
+// -------------------------------------------------------
+// Class mvc::NotificationPool
+// -------------------------------------------------------
+NotificationPool * NotificationPool::getInstance() {
+	// Never destroyed: notifications may be released during static destruction
+	static NotificationPool * pInstance = new NotificationPool();
+	return pInstance;
+}
+
+// -------------------------------------------------------
+NotificationPool::NotificationPool()
+	: m_Head(0), m_ChunkCount(0) {
+	for (auto & chunk : m_Chunks) {
+		chunk.store(nullptr, std::memory_order_relaxed);
+		}
+}
+
+// -------------------------------------------------------
+NotificationObject * NotificationPool::at(uint32_t index) const {
+	return m_Chunks[index / CHUNK_SIZE].load(std::memory_order_acquire) + (index % CHUNK_SIZE);
+}
+
+// -------------------------------------------------------
+NotificationObject * NotificationPool::acquire() {
+	for (;;) {
+		uint64_t head = m_Head.load(std::memory_order_acquire);
+		uint32_t idx  = static_cast<uint32_t>(head);
+		if (idx == 0) {
+			if (m_ChunkCount.load(std::memory_order_acquire) >= MAX_CHUNKS) {
+				// Pool is exhausted, falls back to the heap
+				NotificationObject * pNO = new NotificationObject();
+				pNO->m_Index = UNPOOLED;
+				return pNO;
+				}
+			grow();
+			continue;
+			}
+
+		// Records are never freed, hence reading m_Next of a popped record is safe;
+		// the tag makes the CAS fail if the head has been popped and pushed meanwhile.
+		NotificationObject * pNO  = at(idx - 1);
+		uint64_t next    = pNO->m_Next.load(std::memory_order_relaxed);
+		uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+		if (m_Head.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_relaxed))
+			return pNO;
+		}
+}
+
+// -------------------------------------------------------
+void NotificationPool::release(NotificationObject * pNO) {
+	if (pNO->m_Index == UNPOOLED)
+		delete pNO;
+	else
+		push(pNO);
+}
+
+// -------------------------------------------------------
+void NotificationPool::push(NotificationObject * pNO) {
+	uint64_t head = m_Head.load(std::memory_order_relaxed);
+	uint64_t newHead;
+	do {
+		pNO->m_Next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+		newHead = (((head >> 32) + 1) << 32) | (pNO->m_Index + 1);
+		} while (!m_Head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
+// -------------------------------------------------------
+void NotificationPool::grow() {
+	std::lock_guard<std::mutex> lock(m_GrowMutex);
+	if (static_cast<uint32_t>(m_Head.load(std::memory_order_acquire)) != 0)
+		return; // Another thread has refilled the free list
+
+	const uint32_t chunk = m_ChunkCount.load(std::memory_order_relaxed);
+	if (chunk >= MAX_CHUNKS)
+		return;
+
+	NotificationObject * pChunk = new NotificationObject[CHUNK_SIZE];
+	for (uint32_t i = 0; i < CHUNK_SIZE; i++) {
+		pChunk[i].m_Index = chunk * CHUNK_SIZE + i;
+		}
+	m_Chunks[chunk].store(pChunk, std::memory_order_release);
+	m_ChunkCount.store(chunk + 1, std::memory_order_release);
+	for (uint32_t i = 0; i < CHUNK_SIZE; i++) {
+		push(&pChunk[i]);
+		}
+}
+
+}}} // End namespaces
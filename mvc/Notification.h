@@ -0,0 +1,102 @@
+#ifndef _DE_BSWALZ_MVC_NOTIFICATION_H_
+#define _DE_BSWALZ_MVC_NOTIFICATION_H_
+
+/**
+ * Notification records of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#ifdef DE_BSWALZ_MVC_STATISTICS
+#include <chrono>
+#endif
+#include <cstdint>
+#include <mutex>
+
+namespace de { namespace bswalz { namespace mvc {
+
+class Model;
+class Anchor;
+
+/**
+ * A pending update notification of a model in non-synchronized mode.
+ */
+struct NotificationObject {
+	Model *                 m_pModel;     // nullptr if the model has been deleted while queued
+	Anchor *                m_pAnchor;    // Counted reference, outlives the model
+	void *                  m_pObject;
+#ifdef DE_BSWALZ_MVC_STATISTICS
+	std::chrono::steady_clock::time_point m_Enqueued;
+#endif
+	// Managed by NotificationPool
+	uint32_t                m_Index;
+	std::atomic<uint32_t>   m_Next;
+};
+
+/**
+ * Lock-free pool of notification records.<br>
+ * Records are allocated in chunks and never returned to the heap, hence
+ * acquire() and release() perform no heap allocation once the pool is warm.
+ * The free list is a Treiber stack of record indices with an ABA tag.
+ */
+class NotificationPool {
+public:
+	/**
+	 * @return the pool instance
+	 */
+	static NotificationPool * getInstance();
+
+	/**
+	 * @return an unused notification record
+	 */
+	NotificationObject * acquire();
+
+	/**
+	 * Returns a record to the pool
+	 * @param pNO the record obtained by acquire()
+	 */
+	void release(NotificationObject * pNO);
+
+private:
+	NotificationPool();
+	NotificationPool(const NotificationPool &);
+	NotificationPool & operator=(const NotificationPool &);
+
+	static const uint32_t CHUNK_SIZE = 256;
+	static const uint32_t MAX_CHUNKS = 1024;
+
+	NotificationObject * at(uint32_t index) const;
+	void                 push(NotificationObject * pNO);
+	void                 grow();
+
+	// (tag << 32) | (index + 1), the index 0 indicates an empty list
+	std::atomic<uint64_t>              m_Head;
+	std::atomic<NotificationObject *>  m_Chunks[MAX_CHUNKS];
+	std::atomic<uint32_t>              m_ChunkCount;
+	std::mutex                         m_GrowMutex;
+}; // End of class NotificationPool
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_NOTIFICATION_H_*/
@@ -0,0 +1,249 @@
+/**
+ * Registry class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Registry.h"
+#include "Model.h"
+#include "View.h"
+#include <stdexcept>
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Class mvc::Registry
+// -------------------------------------------------------
+std::atomic<size_t> Registry::m_Subscriptions(0);
+
+// -------------------------------------------------------
+Registry * Registry::getInstance() {
+	// Never destroyed: models may be destroyed during static destruction
+	static Registry * pInstance = new Registry();
+	return pInstance;
+}
+
+// -------------------------------------------------------
+Registry::Handle Registry::add(Model * pModel) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto it = m_Index.find(pModel->getName());
+	if (it != m_Index.end()) {
+		const Slot & slot = getSlot(it->second);
+		if (slot.m_pModel.load(std::memory_order_relaxed) != pModel)
+			throw std::logic_error("de::bswalz::mvc::Registry::add: name '" + pModel->getName() + "' already registered");
+		Handle handle;
+		handle.m_Index      = it->second;
+		handle.m_Generation = slot.m_Generation.load(std::memory_order_relaxed);
+		return handle;
+		}
+
+	uint32_t index = 0;
+	if (!m_FreeSlots.empty()) {
+		index = m_FreeSlots.back();
+		m_FreeSlots.pop_back();
+		}
+	else {
+		if (m_SlotCount == CHUNK_SIZE * MAX_CHUNKS)
+			throw std::logic_error("de::bswalz::mvc::Registry::add: too many models");
+		index = m_SlotCount++;
+		if (index % CHUNK_SIZE == 0)
+			m_Chunks[index / CHUNK_SIZE].store(new Slot[CHUNK_SIZE], std::memory_order_release);
+		}
+	Slot & slot = getSlot(index);
+	uint32_t generation = slot.m_Generation.load(std::memory_order_relaxed) + 1;
+	if (generation == 0)
+		generation = 1; // 0 is reserved for the invalid handle
+	// The new generation is published first, get() then rejects the old handles
+	slot.m_Generation.store(generation, std::memory_order_release);
+	slot.m_pModel.store(pModel, std::memory_order_release);
+	m_Index.emplace(pModel->getName(), index);
+	pModel->m_pRegistryNode.store(getNode(pModel->getName()), std::memory_order_release);
+
+	Handle handle;
+	handle.m_Index      = index;
+	handle.m_Generation = generation;
+	return handle;
+}
+
+// -------------------------------------------------------
+void Registry::remove(Model * pModel) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto it = m_Index.find(pModel->getName());
+	if (it == m_Index.end() || getSlot(it->second).m_pModel.load(std::memory_order_relaxed) != pModel)
+		return;
+	getSlot(it->second).m_pModel.store(nullptr, std::memory_order_release);
+	m_FreeSlots.push_back(it->second);
+	m_Index.erase(it);
+	pModel->m_pRegistryNode.store(nullptr, std::memory_order_release);
+}
+
+// -------------------------------------------------------
+Registry::Handle Registry::resolve(const std::string & name) const {
+	Handle handle;
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto it = m_Index.find(name);
+	if (it != m_Index.end()) {
+		handle.m_Index      = it->second;
+		handle.m_Generation = getSlot(it->second).m_Generation.load(std::memory_order_relaxed);
+		}
+	return handle;
+}
+
+// -------------------------------------------------------
+size_t Registry::resolve(const std::vector<std::string> & names, std::vector<Handle> & handles) const {
+	size_t resolved = 0;
+	handles.assign(names.size(), Handle());
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (size_t i = 0; i < names.size(); i++) {
+		auto it = m_Index.find(names[i]);
+		if (it != m_Index.end()) {
+			handles[i].m_Index      = it->second;
+			handles[i].m_Generation = getSlot(it->second).m_Generation.load(std::memory_order_relaxed);
+			resolved++;
+			}
+		}
+	return resolved;
+}
+
+// -------------------------------------------------------
+// The slot of an allocated index, the chunk is published before the index is used
+Registry::Slot & Registry::getSlot(uint32_t index) const {
+	return m_Chunks[index / CHUNK_SIZE].load(std::memory_order_acquire)[index % CHUNK_SIZE];
+}
+
+// -------------------------------------------------------
+Model * Registry::get(Handle handle) const {
+	if (!handle.isValid() || handle.m_Index >= CHUNK_SIZE * MAX_CHUNKS)
+		return nullptr;
+	const Slot * pChunk = m_Chunks[handle.m_Index / CHUNK_SIZE].load(std::memory_order_acquire);
+	if (pChunk == nullptr)
+		return nullptr;
+	const Slot & slot = pChunk[handle.m_Index % CHUNK_SIZE];
+	if (slot.m_Generation.load(std::memory_order_acquire) != handle.m_Generation)
+		return nullptr;
+	Model * pModel = slot.m_pModel.load(std::memory_order_acquire);
+	// A model stored by a reuse of the slot is preceded by its generation, see add()
+	return (slot.m_Generation.load(std::memory_order_relaxed) == handle.m_Generation) ? pModel : nullptr;
+}
+
+// -------------------------------------------------------
+void Registry::get(const std::vector<Handle> & handles, std::vector<Model *> & models) const {
+	models.resize(handles.size());
+	for (size_t i = 0; i < handles.size(); i++) {
+		models[i] = get(handles[i]);
+		}
+}
+
+// -------------------------------------------------------
+Model * Registry::find(const std::string & name) const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto it = m_Index.find(name);
+	return (it != m_Index.end()) ? getSlot(it->second).m_pModel.load(std::memory_order_relaxed) : nullptr;
+}
+
+// -------------------------------------------------------
+size_t Registry::size() const {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Index.size();
+}
+
+// -------------------------------------------------------
+// Creates the missing nodes of the dotted name, m_Mutex has to be locked
+RegistryNode * Registry::getNode(const std::string & name) {
+	RegistryNode * pNode = &m_Root;
+	size_t begin = 0;
+	while (begin < name.size()) {
+		size_t end = name.find('.', begin);
+		if (end == std::string::npos)
+			end = name.size();
+		std::unique_ptr<RegistryNode> & upChild = pNode->m_Children[name.substr(begin, end - begin)];
+		if (upChild.get() == nullptr)
+			upChild.reset(new RegistryNode(m_Grace, pNode));
+		pNode = upChild.get();
+		begin = end + 1;
+		}
+	return pNode;
+}
+
+// -------------------------------------------------------
+// Finds the node of the dotted name without creating nodes, m_Mutex has to be locked
+RegistryNode * Registry::findNode(const std::string & name) const {
+	const RegistryNode * pNode = &m_Root;
+	size_t begin = 0;
+	while (begin < name.size()) {
+		size_t end = name.find('.', begin);
+		if (end == std::string::npos)
+			end = name.size();
+		auto it = pNode->m_Children.find(name.substr(begin, end - begin));
+		if (it == pNode->m_Children.end())
+			return nullptr;
+		pNode = it->second.get();
+		begin = end + 1;
+		}
+	return const_cast<RegistryNode *>(pNode);
+}
+
+// -------------------------------------------------------
+void Registry::subscribe(const std::string & prefix, View * pView) {
+	RegistryNode * pNode = nullptr;
+	const RegistryNode::ViewSet * pOldViews = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		pNode = getNode(prefix);
+		const RegistryNode::ViewSet * pCurrent = pNode->m_Views.load();
+		if (pCurrent != nullptr && pCurrent->count(pView) > 0)
+			return;
+		RegistryNode::ViewSet * pViews = (pCurrent != nullptr) ? new RegistryNode::ViewSet(*pCurrent) : new RegistryNode::ViewSet();
+		pViews->insert(pView);
+		// The node is the key of the subscription, see View::execute()
+		pView->addSource(pNode);
+		pOldViews = pNode->m_Views.exchange(pViews);
+		m_Subscriptions.fetch_add(1, std::memory_order_release);
+		}
+	// Readers may still iterate the old snapshot
+	pNode->m_Views.retire(pOldViews);
+}
+
+// -------------------------------------------------------
+void Registry::unsubscribe(const std::string & prefix, View * pView) {
+	RegistryNode * pNode = nullptr;
+	const RegistryNode::ViewSet * pOldViews = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		pNode = findNode(prefix);
+		if (pNode == nullptr)
+			return;
+		const RegistryNode::ViewSet * pCurrent = pNode->m_Views.load();
+		if (pCurrent == nullptr || pCurrent->count(pView) == 0)
+			return;
+		RegistryNode::ViewSet * pViews = new RegistryNode::ViewSet(*pCurrent);
+		pViews->erase(pView);
+		pOldViews = pNode->m_Views.exchange(pViews);
+		m_Subscriptions.fetch_sub(1, std::memory_order_release);
+		}
+	// Grace period: no other thread updates the view by the subscription afterwards, skipped by a reader
+	pNode->m_Views.retire(pOldViews);
+	pView->removeSource(pNode);
+}
+
+}}} // End namespaces
@@ -0,0 +1,223 @@
+#ifndef _DE_BSWALZ_MVC_REGISTRY_H_
+#define _DE_BSWALZ_MVC_REGISTRY_H_
+
+/**
+ * Registry class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of Registry
+ * -------------------------------------------------------------------------
+ *	// At start-up
+ *	mvc::Registry::getInstance()->add(m_pGainParameter.get());
+ *	mvc::Registry::getInstance()->add(m_pBalanceParameter.get());
+ *
+ *	// Remote control: names are resolved once, the handles are kept
+ *	std::vector<mvc::Registry::Handle> handles;
+ *	mvc::Registry::getInstance()->resolve(names, handles);
+ *	...
+ *	mvc::Model * pModel = mvc::Registry::getInstance()->get(handles[i]); // nullptr if destroyed
+ *
+ *	// A view updated by every registered model below audio.mixer, e.g. audio.mixer.ch3.gain
+ *	mvc::Registry::getInstance()->subscribe("audio.mixer", m_pMixerView);
+ */
+
+#include "../FlatSet.h"
+#include "GracePeriod.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+class Model;
+class View;
+
+/**
+ * A node of the name trie of the Registry, one per segment of a dotted name.<br>
+ * Nodes are never removed, hence a model walks from its node to the root
+ * without any lock.
+ */
+struct RegistryNode {
+	typedef de::bswalz::flat_set<View *, 4> ViewSet;
+
+	RegistryNode(GracePeriod & grace, RegistryNode * pParent) : m_pParent(pParent), m_Children(), m_Views(grace) {}
+
+	RegistryNode * m_pParent;       // nullptr for the root
+	std::unordered_map<std::string, std::unique_ptr<RegistryNode>> m_Children; // Guarded by Registry
+	TRcuPointer<ViewSet> m_Views;   // Subscribed to the prefix, copy-on-write like Model
+};
+
+/**
+ * The Registry indexes models by their names. Registration is optional, a model
+ * is added explicitly and removed by its destructor.<br>
+ * A name is resolved to a handle by a hash lookup. A handle stays valid as long
+ * as its model is registered, get() then returns the model by an array access
+ * without any lock. The handle of a destroyed model is detected, it never refers
+ * to another model.<br>
+ * The dotted names form a trie. A view subscribed to a prefix is updated by every
+ * registered model below the prefix, the notification walks from the model's node
+ * to the root, hence the routing costs O(depth of the name) for any number of
+ * subscriptions.
+ */
+class Registry {
+public:
+	/**
+	 * The stable handle of a registered model
+	 */
+	struct Handle {
+		uint32_t m_Index;
+		uint32_t m_Generation;  // 0 for the invalid handle
+
+		Handle() : m_Index(0), m_Generation(0) {}
+		/** @return true if the handle has been resolved */
+		bool isValid() const { return m_Generation != 0; }
+		bool operator==(const Handle & r) const { return m_Index == r.m_Index && m_Generation == r.m_Generation; }
+		bool operator!=(const Handle & r) const { return !(*this == r); }
+	};
+
+	/**
+	 * @return the registry instance
+	 */
+	static Registry * getInstance();
+
+	/**
+	 * Adds a model by its name. Adding a registered model again returns its handle.
+	 * Throws std::logic_error if another model with the same name is registered.
+	 * @param pModel the model
+	 * @return the handle of the model
+	 */
+	Handle add(Model * pModel);
+
+	/**
+	 * Removes a model. Called by the destructor of Model.
+	 * @param pModel the model to be removed
+	 */
+	void remove(Model * pModel);
+
+	/**
+	 * @param name the name of a model
+	 * @return the handle of the model, an invalid handle if the name is not registered
+	 */
+	Handle resolve(const std::string & name) const;
+
+	/**
+	 * Resolves several names with a single lock
+	 * @param names the names of models
+	 * @param handles receives the handles in order of names, invalid for unknown names
+	 * @return the number of resolved names
+	 */
+	size_t resolve(const std::vector<std::string> & names, std::vector<Handle> & handles) const;
+
+	/**
+	 * Lock-free, the model is read between two reads of the generation of its slot
+	 * @param handle the handle of a model
+	 * @return the model, nullptr if the handle is invalid or its model has been removed
+	 */
+	Model * get(Handle handle) const;
+
+	/**
+	 * Gets several models, lock-free like get()
+	 * @param handles the handles
+	 * @param models receives the models in order of handles, nullptr for invalid handles
+	 */
+	void get(const std::vector<Handle> & handles, std::vector<Model *> & models) const;
+
+	/**
+	 * @param name the name of a model
+	 * @return the model, nullptr if the name is not registered
+	 */
+	Model * find(const std::string & name) const;
+
+	/**
+	 * @return the number of registered models
+	 */
+	size_t size() const;
+
+	/**
+	 * Subscribes a view to all registered models whose name equals the prefix or starts
+	 * with the prefix followed by a dot. "audio.mixer" matches "audio.mixer.ch3.gain",
+	 * but not "audio.mixers.gain". The empty prefix matches every registered model.<br>
+	 * The view is updated like a registered view, after the views of the model.
+	 * It has to be unsubscribed before its destruction.
+	 * @param prefix the dotted prefix
+	 * @param pView the view
+	 */
+	void subscribe(const std::string & prefix, View * pView);
+
+	/**
+	 * Removes the subscription of a view to a prefix. Waits until no other thread
+	 * updates the view by the subscription, unless called within an update.
+	 * @param prefix the dotted prefix
+	 * @param pView the view
+	 */
+	void unsubscribe(const std::string & prefix, View * pView);
+
+	/**
+	 * @return true if any view is subscribed to a prefix
+	 */
+	static bool hasSubscriptions() { return m_Subscriptions.load(std::memory_order_acquire) > 0; }
+
+private:
+	friend class Model;
+
+	Registry() : m_Chunks(), m_SlotCount(0), m_Grace(), m_Root(m_Grace, nullptr) {}
+	Registry(const Registry &);
+	Registry & operator=(const Registry &);
+
+	/**
+	 * The slots are allocated in chunks which are never moved nor freed, hence
+	 * get() reads them without the lock. Written under m_Mutex only.
+	 */
+	struct Slot {
+		Slot() : m_pModel(nullptr), m_Generation(0) {}
+		std::atomic<Model *>  m_pModel;       // nullptr if free
+		std::atomic<uint32_t> m_Generation;   // Incremented at every reuse of the slot
+	};
+
+	static const uint32_t CHUNK_SIZE = 256;   // Slots per chunk
+	static const uint32_t MAX_CHUNKS = 4096;  // Up to 1M registered models
+
+	Slot & getSlot(uint32_t index) const;
+	RegistryNode * getNode(const std::string & name);
+	RegistryNode * findNode(const std::string & name) const;
+
+	std::unordered_map<std::string, uint32_t> m_Index;     // Name -> index of slot
+	std::atomic<Slot *>                       m_Chunks[MAX_CHUNKS];
+	uint32_t                                  m_SlotCount; // Guarded by m_Mutex
+	std::vector<uint32_t>                     m_FreeSlots;
+	GracePeriod                               m_Grace;     // Protects the subscriptions of all nodes
+	RegistryNode                              m_Root;
+	mutable std::mutex                        m_Mutex;
+
+	static std::atomic<size_t>                m_Subscriptions;
+}; // End of class Registry
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_REGISTRY_H_*/
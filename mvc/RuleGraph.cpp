@@ -0,0 +1,163 @@
+/**
+ * Dependency graph of AssignRules of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RuleGraph.h"
+#include "Model.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Class mvc::RuleGraph
+// -------------------------------------------------------
+RuleGraph * RuleGraph::getInstance() {
+	// Never destroyed: models may be destroyed during static destruction
+	static RuleGraph * pInstance = new RuleGraph();
+	return pInstance;
+}
+
+// -------------------------------------------------------
+unsigned int RuleGraph::getRank(const Model * pModel) {
+	return pModel->m_Rank.load(std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------
+bool RuleGraph::reachesFanIn(const Model * pModel) {
+	return pModel->m_ReachesFanIn.load(std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------
+void RuleGraph::addRule(Model * pSource, const IAssignRule * pRule) {
+	const std::vector<Model *> & targets = pRule->getTargets();
+	if (targets.empty())
+		return;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (auto pTarget : targets) {
+		if (pTarget == pSource || reaches(pTarget, pSource))
+			throw std::logic_error("de::bswalz::mvc::RuleGraph::addRule: cycle from '"
+			                       + pSource->getName() + "' to '" + pTarget->getName() + "'");
+		}
+
+	std::vector<Model *> & successors = m_Successors[pSource];
+	for (auto pTarget : targets) {
+		successors.push_back(pTarget);
+		m_Predecessors[pTarget].push_back(pSource);
+		pTarget->m_InRuleGraph = true;
+		}
+	pSource->m_InRuleGraph = true;
+	raiseRanks(pSource);
+	markFanIns();
+}
+
+// -------------------------------------------------------
+void RuleGraph::removeModel(Model * pModel) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto succ = m_Successors.find(pModel);
+	if (succ != m_Successors.end()) {
+		for (auto pTarget : succ->second) {
+			std::vector<Model *> & preds = m_Predecessors[pTarget];
+			preds.erase(std::remove(preds.begin(), preds.end(), pModel), preds.end());
+			}
+		m_Successors.erase(succ);
+		}
+	auto pred = m_Predecessors.find(pModel);
+	if (pred != m_Predecessors.end()) {
+		for (auto pSource : pred->second) {
+			std::vector<Model *> & succs = m_Successors[pSource];
+			succs.erase(std::remove(succs.begin(), succs.end(), pModel), succs.end());
+			}
+		m_Predecessors.erase(pred);
+		}
+	// The ranks of the remaining models are still a valid topological order
+	markFanIns();
+}
+
+// -------------------------------------------------------
+// Depth-first search, called with locked m_Mutex
+bool RuleGraph::reaches(Model * pFrom, Model * pTo) {
+	std::vector<Model *>        stack(1, pFrom);
+	std::unordered_set<Model *> visited;
+	while (!stack.empty()) {
+		Model * pModel = stack.back();
+		stack.pop_back();
+		if (pModel == pTo)
+			return true;
+		if (!visited.insert(pModel).second)
+			continue;
+		auto succ = m_Successors.find(pModel);
+		if (succ != m_Successors.end())
+			stack.insert(stack.end(), succ->second.begin(), succ->second.end());
+		}
+	return false;
+}
+
+// -------------------------------------------------------
+// Ensures rank(source) < rank(target) downstream of pSource, called with locked m_Mutex
+void RuleGraph::raiseRanks(Model * pSource) {
+	std::vector<Model *> stack(1, pSource);
+	while (!stack.empty()) {
+		Model * pModel = stack.back();
+		stack.pop_back();
+		const unsigned int rank = pModel->m_Rank.load(std::memory_order_relaxed);
+		auto succ = m_Successors.find(pModel);
+		if (succ == m_Successors.end())
+			continue;
+		for (auto pTarget : succ->second) {
+			if (pTarget->m_Rank.load(std::memory_order_relaxed) <= rank) {
+				pTarget->m_Rank.store(rank + 1, std::memory_order_relaxed);
+				stack.push_back(pTarget);
+				}
+			}
+		}
+}
+
+// -------------------------------------------------------
+// Marks the models upstream of a model with several sources, called with locked m_Mutex
+void RuleGraph::markFanIns() {
+	std::vector<Model *>        stack;
+	std::unordered_set<Model *> upstream;
+	for (auto & pred : m_Predecessors) {
+		if (pred.second.size() > 1)
+			stack.insert(stack.end(), pred.second.begin(), pred.second.end());
+		}
+	while (!stack.empty()) {
+		Model * pModel = stack.back();
+		stack.pop_back();
+		if (!upstream.insert(pModel).second)
+			continue;
+		auto pred = m_Predecessors.find(pModel);
+		if (pred != m_Predecessors.end())
+			stack.insert(stack.end(), pred->second.begin(), pred->second.end());
+		}
+	for (auto & succ : m_Successors) {
+		succ.first->m_ReachesFanIn.store(upstream.count(succ.first) != 0, std::memory_order_relaxed);
+		}
+}
+
+}}} // End namespaces
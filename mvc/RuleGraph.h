@@ -0,0 +1,99 @@
+#ifndef _DE_BSWALZ_MVC_RULEGRAPH_H_
+#define _DE_BSWALZ_MVC_RULEGRAPH_H_
+
+/**
+ * Dependency graph of AssignRules of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+class Model;
+class IAssignRule;
+
+/**
+ * The RuleGraph holds the edges 'source model -> target model' of all AssignRules
+ * which declare their targets (IAssignRule::addTarget).<br>
+ * Every model has a rank with rank(source) < rank(target) for every edge. The
+ * ranks are maintained incrementally at registration of a rule, a rule which
+ * would close a cycle is rejected.<br>
+ * Transaction::commit() applies the AssignRules of the touched models in the
+ * order of their ranks, hence every model of a diamond-shaped graph is
+ * evaluated and notified once. Only an assignment to a model upstream of a
+ * fan-in (a model with several sources) needs the transaction, all other
+ * assignments propagate directly without allocation.
+ */
+class RuleGraph {
+public:
+	/**
+	 * @return the graph instance
+	 */
+	static RuleGraph * getInstance();
+
+	/**
+	 * Adds the edges of an AssignRule.
+	 * Throws std::logic_error if the rule would close a cycle; the graph is left unchanged.
+	 * @param pSource the model the rule is added to
+	 * @param pRule the rule with its declared targets
+	 */
+	void addRule(Model * pSource, const IAssignRule * pRule);
+
+	/**
+	 * Removes a model and all its edges. Called by the destructor of Model.
+	 * @param pModel the model to be removed
+	 */
+	void removeModel(Model * pModel);
+
+	/**
+	 * @return the rank of the model (0 if the model has no predecessor)
+	 */
+	static unsigned int getRank(const Model * pModel);
+
+	/**
+	 * @return true if a path of AssignRules leads from the model to a model
+	 * with several sources, i.e. the propagation has to be ordered by a Transaction
+	 */
+	static bool reachesFanIn(const Model * pModel);
+
+private:
+	RuleGraph() {}
+	RuleGraph(const RuleGraph &);
+	RuleGraph & operator=(const RuleGraph &);
+
+	bool reaches(Model * pFrom, Model * pTo);
+	void raiseRanks(Model * pSource);
+	void markFanIns();
+
+	std::unordered_map<Model *, std::vector<Model *>> m_Successors;
+	std::unordered_map<Model *, std::vector<Model *>> m_Predecessors;
+	std::mutex                                        m_Mutex;
+}; // End of class RuleGraph
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_RULEGRAPH_H_*/
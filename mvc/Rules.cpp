@@ -0,0 +1,86 @@
+/**
+ * Rules classes of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Rules.h"
+#include "Model.h"
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// Class mvc::IVoter
+// -------------------------------------------------------
+bool IVoter::getVote() {
+	uint64_t generation;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Inputs.empty())
+			generation = 0; // Nothing declared, nothing to memoize
+		else {
+			bool valid = m_Valid;
+			for (auto & input : m_Inputs) {
+				// The revisions are read before vote(), a modification during vote() causes a new vote
+				const uint64_t revision = input.m_pModel->getRevision();
+				if (revision != input.m_Revision) {
+					input.m_Revision = revision;
+					valid         = false;
+					}
+				}
+			if (valid)
+				return m_Vote;
+			m_Valid    = false;
+			generation = ++m_Generation;
+			}
+	}
+
+	// Votes without the lock, vote() reads models which may be locked by other threads
+	const bool result = vote();
+	if (generation != 0) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Generation == generation) {
+			// Neither a newer snapshot nor invalidate() in the meantime
+			m_Vote  = result;
+			m_Valid = true;
+			}
+		}
+	return result;
+}
+
+// -------------------------------------------------------
+void IVoter::invalidate() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Valid = false;
+	m_Generation++;
+}
+
+// -------------------------------------------------------
+void IVoter::dependsOn(const Model * pModel) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Inputs.push_back(Input{ pModel, 0 });
+	m_Valid = false;
+	m_Generation++;
+}
+
+}}} // End namespaces
@@ -34,7 +34,10 @@
  *	class MyAssignRule : public TAssignRule<unsigned short> {
  *	public:
  *		MyAssignRule(CUIntParameter * pDestParameter)
- *			: TAssignRule<unsigned short>(), m_pDestParameter(pDestParameter) {}
+ *			: TAssignRule<unsigned short>(), m_pDestParameter(pDestParameter) {
+ *							// Optional: enables ordering and cycle detection by RuleGraph
+ *							addTarget(pDestParameter);
+ *							}
  *		virtual ~MyAssignRule() {}
  *		virtual void apply(TModel<unsigned short> * pSource) override {
  *							unsigned short v = dynamic_cast<CUShortParameter*>(pSource)->getValue();
@@ -44,7 +47,7 @@
  *							m_pDestParameter->revertAssignment();
  *							};
  *		virtual bool validate() override {
- *							return m_pDestParameter->getVoter()->vote();
+ *							return m_pDestParameter->getVoter()->getVote();
  *							};
  *	private:
  *		CUIntParameter * m_pDestParameter;
@@ -57,7 +60,10 @@
  *	class MyVoter : public TVoter<unsigned int> {
  *	public:
  *		MyVoter(CUIntParameter * pParameter)
- *			: TVoter<unsigned int>(), m_pDestParameter(pParameter) {}
+ *			: TVoter<unsigned int>(), m_pDestParameter(pParameter) {
+ *							// Optional: vote() is only invoked again if pParameter has changed
+ *							dependsOn(pParameter);
+ *							}
  *		virtual ~MyVoter() {}
  *		virtual bool vote() override {
  *							unsigned int v = m_pDestParameter->getValue();
@@ -70,8 +76,13 @@
  *	m_pUIntParameter->setVoter(m_pUIntVoter);
  */
 
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
 namespace de { namespace bswalz { namespace mvc {
 
+class Model;
 template <typename T> class TModel;
 
 /**
@@ -80,6 +91,23 @@ template <typename T> class TModel;
 class IAssignRule {
 public:
 	virtual ~IAssignRule() = 0;
+
+	/**
+	 * @return the models which are assigned by this rule (empty if not declared)
+	 * @see RuleGraph
+	 */
+	const std::vector<Model *> & getTargets() const { return m_Targets; }
+
+protected:
+	/**
+	 * Declares a model which is assigned by this rule. Must be called before
+	 * the rule is added to its source model.
+	 * @param pModel the target model
+	 */
+	void addTarget(Model * pModel) { m_Targets.push_back(pModel); }
+
+private:
+	std::vector<Model *> m_Targets;
 };
 inline IAssignRule::~IAssignRule() {}
 
@@ -99,15 +127,60 @@ public:
 	virtual bool validate() { return true; }
 };
 
+/**
+ * Base class of TVoter, which memoizes the result of vote().<br>
+ * A voter may declare the models it reads (dependsOn). getVote() then invokes
+ * vote() only if one of these models has been modified since the last vote,
+ * as indicated by Model::getRevision(). Without declared models every call of
+ * getVote() invokes vote().<br>
+ * vote() is invoked without a lock held, hence it may run in several threads at once.
+ */
+class IVoter {
+public:
+	IVoter() : m_Inputs(), m_Valid(false), m_Vote(false), m_Generation(0) {};
+	virtual ~IVoter() {};
+	virtual bool vote() = 0;
+
+	/**
+	 * @return the (memoized) result of vote()
+	 */
+	bool getVote();
+
+	/**
+	 * Discards the memoized result, e.g. if the voter depends on undeclared state
+	 */
+	void invalidate();
+
+protected:
+	/**
+	 * Declares a model which is read by vote(). The model must outlive the voter.
+	 * @param pModel the model
+	 */
+	void dependsOn(const Model * pModel);
+
+private:
+	IVoter(const IVoter &);
+	IVoter & operator=(const IVoter &);
+
+	struct Input {
+		const Model * m_pModel;
+		uint64_t      m_Revision;
+	};
+	std::vector<Input> m_Inputs;
+	bool               m_Valid;
+	bool               m_Vote;
+	uint64_t           m_Generation;  // Advanced by every snapshot of the revisions and by invalidate()
+	std::mutex         m_Mutex;
+};
+
 /**
  * TVoter::vote is applied during commitment of a parameter's value.<br>
  * The intentions behind the TVoter is verifying the consistency of an entire set of models.
  */
-template <typename T> class TVoter {
+template <typename T> class TVoter : public IVoter {
 public:
 	TVoter() {};
 	virtual ~TVoter() {};
-	virtual bool vote() = 0;
 };
 
 }}} // End namespaces
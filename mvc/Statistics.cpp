@@ -0,0 +1,347 @@
+/**
+ * Notification statistics of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Statistics.h"
+#include "Model.h"
+#include "View.h"
+#include <algorithm>
+#include <cstdlib>
+#include <typeinfo>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace de { namespace bswalz { namespace mvc {
+
+// -------------------------------------------------------
+// @return the readable name of the dynamic type of the view
+static std::string getTypeName(const View * pView) {
+	const char * pName = typeid(*pView).name();
+#ifdef __GNUG__
+	int    status     = 0;
+	char * pDemangled = abi::__cxa_demangle(pName, nullptr, nullptr, &status);
+	if (pDemangled != nullptr) {
+		std::string name(pDemangled);
+		std::free(pDemangled);
+		return name;
+		}
+#endif
+	return std::string(pName);
+}
+
+// -------------------------------------------------------
+// Class mvc::Statistics::Histogram
+// -------------------------------------------------------
+Statistics::Histogram::Histogram()
+	: m_Count(0), m_Total(0), m_Max(0) {
+	std::fill(m_Buckets, m_Buckets + BUCKETS, 0);
+}
+
+// -------------------------------------------------------
+void Statistics::Histogram::add(uint64_t ns) {
+	unsigned int bucket = 0;
+	while (bucket < BUCKETS - 1 && (ns >> (bucket + 1)) != 0)
+		bucket++;
+	m_Buckets[bucket]++;
+	m_Count++;
+	m_Total += ns;
+	if (ns > m_Max)
+		m_Max = ns;
+}
+
+// -------------------------------------------------------
+uint64_t Statistics::Histogram::getMean() const {
+	return (m_Count > 0) ? m_Total / m_Count : 0;
+}
+
+// -------------------------------------------------------
+uint64_t Statistics::Histogram::getPercentile(double p) const {
+	const uint64_t rank = static_cast<uint64_t>(p * m_Count);
+	uint64_t count = 0;
+	for (unsigned int i = 0; i < BUCKETS; i++) {
+		count += m_Buckets[i];
+		if (count > rank)
+			return std::min(m_Max, (uint64_t(2) << i) - 1);
+		}
+	return m_Max;
+}
+
+// -------------------------------------------------------
+// Class mvc::Statistics::AtomicHistogram
+// -------------------------------------------------------
+Statistics::AtomicHistogram::AtomicHistogram()
+	: m_Count(0), m_Total(0), m_Max(0) {
+	for (auto & bucket : m_Buckets)
+		bucket.store(0, std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------
+void Statistics::AtomicHistogram::add(uint64_t ns) {
+	unsigned int bucket = 0;
+	while (bucket < Histogram::BUCKETS - 1 && (ns >> (bucket + 1)) != 0)
+		bucket++;
+	m_Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	m_Count.fetch_add(1, std::memory_order_relaxed);
+	m_Total.fetch_add(ns, std::memory_order_relaxed);
+	uint64_t max = m_Max.load(std::memory_order_relaxed);
+	while (ns > max && !m_Max.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+		; // max has been reloaded
+}
+
+// -------------------------------------------------------
+Statistics::Histogram Statistics::AtomicHistogram::load() const {
+	Histogram histogram;
+	for (unsigned int i = 0; i < Histogram::BUCKETS; i++)
+		histogram.m_Buckets[i] = m_Buckets[i].load(std::memory_order_relaxed);
+	histogram.m_Count = m_Count.load(std::memory_order_relaxed);
+	histogram.m_Total = m_Total.load(std::memory_order_relaxed);
+	histogram.m_Max   = m_Max.load(std::memory_order_relaxed);
+	return histogram;
+}
+
+// -------------------------------------------------------
+void Statistics::AtomicHistogram::clear() {
+	for (auto & bucket : m_Buckets)
+		bucket.store(0, std::memory_order_relaxed);
+	m_Count.store(0, std::memory_order_relaxed);
+	m_Total.store(0, std::memory_order_relaxed);
+	m_Max.store(0, std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------
+// Class mvc::Statistics
+// -------------------------------------------------------
+// Marks a removed view, a late update does not attach new statistics
+static ViewStatistics s_Removed;
+// Marks a removed model
+static ModelStatistics s_RemovedModel;
+
+// -------------------------------------------------------
+Statistics * Statistics::getInstance() {
+	// Never destroyed: views and models may be destroyed during static destruction
+	static Statistics * pInstance = new Statistics();
+	return pInstance;
+}
+
+// -------------------------------------------------------
+bool Statistics::isEnabled() {
+#ifdef DE_BSWALZ_MVC_STATISTICS
+	return true;
+#else
+	return false;
+#endif
+}
+
+// -------------------------------------------------------
+Statistics::Statistics()
+	: m_Views(), m_Models(), m_Latency(), m_QueueDepth(0), m_MaxQueueDepth(0) {
+	// Intentionally left blank
+}
+
+// -------------------------------------------------------
+void Statistics::addNotification(const Model * pModel) {
+	ModelStatistics * pStatistics = pModel->m_pStatistics.load(std::memory_order_acquire);
+	if (pStatistics == nullptr)
+		pStatistics = attachModel(pModel);
+	if (pStatistics != &s_RemovedModel)
+		pStatistics->m_Notifications.fetch_add(1, std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------
+// Creates the statistics of a model at its first notification
+ModelStatistics * Statistics::attachModel(const Model * pModel) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (pModel->m_pStatistics.load(std::memory_order_relaxed) == &s_RemovedModel)
+		return &s_RemovedModel;
+	std::unique_ptr<ModelStatistics> & upStatistics = m_Models[pModel];
+	if (!upStatistics) {
+		// Notified by several threads at once, the first one creates the statistics
+		upStatistics.reset(new ModelStatistics());
+		upStatistics->m_pModel = pModel;
+		upStatistics->m_Name   = pModel->getName();
+		upStatistics->m_Notifications.store(0, std::memory_order_relaxed);
+		pModel->m_pStatistics.store(upStatistics.get(), std::memory_order_release);
+		}
+	return upStatistics.get();
+}
+
+// -------------------------------------------------------
+void Statistics::addUpdate(const View * pView, uint64_t ns) {
+	ViewStatistics * pStatistics = pView->m_pStatistics.load(std::memory_order_acquire);
+	if (pStatistics == nullptr)
+		pStatistics = attachView(pView);
+	if (pStatistics != &s_Removed)
+		pStatistics->m_Duration.add(ns);
+}
+
+// -------------------------------------------------------
+// Creates the statistics of a view at its first measured update
+ViewStatistics * Statistics::attachView(const View * pView) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (pView->m_pStatistics.load(std::memory_order_relaxed) == &s_Removed)
+		return &s_Removed;
+	std::unique_ptr<ViewStatistics> & upStatistics = m_Views[pView];
+	if (!upStatistics) {
+		// Updated by several threads at once, the first one creates the statistics
+		upStatistics.reset(new ViewStatistics());
+		upStatistics->m_pView    = pView;
+		upStatistics->m_TypeName = getTypeName(pView);
+		pView->m_pStatistics.store(upStatistics.get(), std::memory_order_release);
+		}
+	return upStatistics.get();
+}
+
+// -------------------------------------------------------
+void Statistics::addLatency(uint64_t ns) {
+	m_Latency.add(ns);
+}
+
+// -------------------------------------------------------
+void Statistics::setQueueDepth(size_t depth) {
+	m_QueueDepth.store(depth, std::memory_order_relaxed);
+	size_t max = m_MaxQueueDepth.load(std::memory_order_relaxed);
+	while (depth > max && !m_MaxQueueDepth.compare_exchange_weak(max, depth, std::memory_order_relaxed))
+		; // max has been reloaded
+}
+
+// -------------------------------------------------------
+void Statistics::removeModel(const Model * pModel) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	// Called by the destructor of the model, no notification is counted any more
+	pModel->m_pStatistics.store(&s_RemovedModel, std::memory_order_relaxed);
+	m_Models.erase(pModel);
+}
+
+// -------------------------------------------------------
+void Statistics::removeView(const View * pView) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	// Called after the view has been unregistered, no update is measured any more
+	pView->m_pStatistics.store(&s_Removed, std::memory_order_relaxed);
+	m_Views.erase(pView);
+}
+
+// -------------------------------------------------------
+std::vector<Statistics::ViewRecord> Statistics::getSlowestViews(size_t n) const {
+	std::vector<ViewRecord> views;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		views.reserve(m_Views.size());
+		for (auto & entry : m_Views) {
+			const ViewStatistics & statistics = *entry.second;
+			views.push_back(ViewRecord{ statistics.m_pView, statistics.m_TypeName, statistics.m_Duration.load() });
+			}
+	}
+	auto slower = [](const ViewRecord & l, const ViewRecord & r) {
+		return l.m_Duration.getMean() > r.m_Duration.getMean(); };
+	if (views.size() > n) {
+		std::partial_sort(views.begin(), views.begin() + n, views.end(), slower);
+		views.resize(n);
+		}
+	else
+		std::sort(views.begin(), views.end(), slower);
+	return views;
+}
+
+// -------------------------------------------------------
+std::vector<Statistics::ModelRecord> Statistics::getBusiestModels(size_t n) const {
+	std::vector<ModelRecord> models;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		models.reserve(m_Models.size());
+		for (auto & entry : m_Models) {
+			const ModelStatistics & statistics = *entry.second;
+			models.push_back(ModelRecord{ statistics.m_pModel, statistics.m_Name, statistics.m_Notifications.load(std::memory_order_relaxed) });
+			}
+	}
+	auto busier = [](const ModelRecord & l, const ModelRecord & r) {
+		return l.m_Notifications > r.m_Notifications; };
+	if (models.size() > n) {
+		std::partial_sort(models.begin(), models.begin() + n, models.end(), busier);
+		models.resize(n);
+		}
+	else
+		std::sort(models.begin(), models.end(), busier);
+	return models;
+}
+
+// -------------------------------------------------------
+Statistics::Histogram Statistics::getLatency() const {
+	return m_Latency.load();
+}
+
+// -------------------------------------------------------
+size_t Statistics::getQueueDepth() const {
+	return m_QueueDepth.load(std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------
+size_t Statistics::getMaxQueueDepth() const {
+	return m_MaxQueueDepth.load(std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------
+void Statistics::dump(std::ostream & os, size_t n) const {
+	if (!isEnabled()) {
+		os << "mvc::Statistics: not compiled in, define DE_BSWALZ_MVC_STATISTICS" << std::endl;
+		return;
+		}
+
+	const Histogram latency = getLatency();
+	os << "mvc::Statistics" << std::endl
+	   << "  queue depth: " << getQueueDepth() << " (max " << getMaxQueueDepth() << ")" << std::endl
+	   << "  latency [ns]: count " << latency.m_Count << ", mean " << latency.getMean()
+	   << ", p99 " << latency.getPercentile(0.99) << ", max " << latency.m_Max << std::endl;
+
+	os << "  slowest views [ns]:" << std::endl;
+	for (auto & view : getSlowestViews(n)) {
+		os << "    " << view.m_TypeName << " @" << static_cast<const void *>(view.m_pView)
+		   << ": count " << view.m_Duration.m_Count << ", mean " << view.m_Duration.getMean()
+		   << ", p99 " << view.m_Duration.getPercentile(0.99) << ", max " << view.m_Duration.m_Max << std::endl;
+		}
+
+	os << "  busiest models:" << std::endl;
+	for (auto & model : getBusiestModels(n)) {
+		os << "    " << model.m_Name << ": " << model.m_Notifications << " notifications" << std::endl;
+		}
+}
+
+// -------------------------------------------------------
+void Statistics::reset() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (auto & entry : m_Views) {
+		// Still attached to its view
+		entry.second->m_Duration.clear();
+		}
+	for (auto & entry : m_Models) {
+		// Still attached to its model
+		entry.second->m_Notifications.store(0, std::memory_order_relaxed);
+		}
+	m_Latency.clear();
+	m_QueueDepth.store(0, std::memory_order_relaxed);
+	m_MaxQueueDepth.store(0, std::memory_order_relaxed);
+}
+
+}}} // End namespaces
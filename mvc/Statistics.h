@@ -0,0 +1,207 @@
+#ifndef _DE_BSWALZ_MVC_STATISTICS_H_
+#define _DE_BSWALZ_MVC_STATISTICS_H_
+
+/**
+ * Notification statistics of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of Statistics
+ * -------------------------------------------------------------------------
+ *	// The statistics are recorded only if the whole build defines
+ *	// DE_BSWALZ_MVC_STATISTICS (e.g. -DDE_BSWALZ_MVC_STATISTICS), otherwise
+ *	// the notification path contains no instrumentation at all.
+ *	if (mvc::Statistics::isEnabled())
+ *		mvc::Statistics::getInstance()->dump(std::cerr, 10); // The 10 slowest views
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+class Model;
+class View;
+struct ModelStatistics;
+struct ViewStatistics;
+
+/**
+ * Collects statistics of the update notifications: notifications per model,
+ * duration of View::update() per view, depth of the UpdateManager's queue and
+ * the latency from enqueueing a notification until its delivery.<br>
+ * The durations, latencies and notifications are counted atomically, hence
+ * neither the parallel fan-out nor concurrent notifiers are serialized. The
+ * histogram of a view is attached to the view by its first measured update, the
+ * counter of a model to the model by its first notification.
+ */
+class Statistics {
+public:
+	/**
+	 * Histogram of durations in nanoseconds with logarithmic buckets.<br>
+	 * Bucket i counts the durations in [2^i, 2^(i+1)), bucket 0 includes 0.
+	 */
+	struct Histogram {
+		static const unsigned int BUCKETS = 40;
+
+		Histogram();
+		void     add(uint64_t ns);
+		/** @return the mean duration in ns */
+		uint64_t getMean() const;
+		/** @return the upper bound of the bucket containing the percentile (0.0 .. 1.0) */
+		uint64_t getPercentile(double p) const;
+
+		uint64_t m_Buckets[BUCKETS];
+		uint64_t m_Count;
+		uint64_t m_Total;
+		uint64_t m_Max;
+	};
+
+	/**
+	 * Histogram which is added to concurrently without a lock
+	 */
+	struct AtomicHistogram {
+		AtomicHistogram();
+		void      add(uint64_t ns);
+		/** @return a copy, counts added concurrently may be missing */
+		Histogram load() const;
+		void      clear();
+
+		std::atomic<uint64_t> m_Buckets[Histogram::BUCKETS];
+		std::atomic<uint64_t> m_Count;
+		std::atomic<uint64_t> m_Total;
+		std::atomic<uint64_t> m_Max;
+	};
+
+	/** The statistics of a view */
+	struct ViewRecord {
+		const View * m_pView;
+		std::string  m_TypeName;     // Dynamic type of the view
+		Histogram    m_Duration;     // Duration of update()
+	};
+
+	/** The statistics of a model */
+	struct ModelRecord {
+		const Model * m_pModel;
+		std::string   m_Name;
+		uint64_t      m_Notifications;
+	};
+
+	/**
+	 * @return the statistics instance
+	 */
+	static Statistics * getInstance();
+
+	/**
+	 * @return true if the statistics are compiled in (DE_BSWALZ_MVC_STATISTICS)
+	 */
+	static bool isEnabled();
+
+	/** Counts a notification of the model */
+	void addNotification(const Model * pModel);
+	/** Adds the duration of an update of the view */
+	void addUpdate(const View * pView, uint64_t ns);
+	/** Adds the latency from enqueueing until delivery of a notification */
+	void addLatency(uint64_t ns);
+	/** Sets the number of queued notifications of the UpdateManager */
+	void setQueueDepth(size_t depth);
+	/** Discards the statistics of a destroyed model */
+	void removeModel(const Model * pModel);
+	/** Discards the statistics of a destroyed view */
+	void removeView(const View * pView);
+
+	/**
+	 * @param n the maximum number of views
+	 * @return the views with the highest mean duration of update(), slowest first
+	 */
+	std::vector<ViewRecord> getSlowestViews(size_t n) const;
+
+	/**
+	 * @param n the maximum number of models
+	 * @return the models with the most notifications, most frequent first
+	 */
+	std::vector<ModelRecord> getBusiestModels(size_t n) const;
+
+	/** @return the histogram of the enqueue-to-delivery latency */
+	Histogram getLatency() const;
+
+	/** @return the current number of queued notifications */
+	size_t    getQueueDepth() const;
+
+	/** @return the maximum number of queued notifications */
+	size_t    getMaxQueueDepth() const;
+
+	/**
+	 * Writes a human readable report
+	 * @param os the output stream
+	 * @param n the number of views and models to be listed
+	 */
+	void dump(std::ostream & os, size_t n = 10) const;
+
+	/** Discards all statistics */
+	void reset();
+
+private:
+	Statistics();
+	Statistics(const Statistics &);
+	Statistics & operator=(const Statistics &);
+
+	ViewStatistics *  attachView(const View * pView);
+	ModelStatistics * attachModel(const Model * pModel);
+
+	mutable std::mutex                                m_Mutex;
+	std::unordered_map<const View *, std::unique_ptr<ViewStatistics>> m_Views;    // Attached to the views
+	std::unordered_map<const Model *, std::unique_ptr<ModelStatistics>> m_Models; // Attached to the models
+	AtomicHistogram                                   m_Latency;
+	std::atomic<size_t>                               m_QueueDepth;
+	std::atomic<size_t>                               m_MaxQueueDepth;
+}; // End of class Statistics
+
+/**
+ * The statistics attached to a model, see Model::m_pStatistics
+ */
+struct ModelStatistics {
+	const Model *         m_pModel;
+	std::string           m_Name;
+	std::atomic<uint64_t> m_Notifications;
+};
+
+/**
+ * The statistics attached to a view, see View::m_pStatistics
+ */
+struct ViewStatistics {
+	const View *                m_pView;
+	std::string                 m_TypeName;
+	Statistics::AtomicHistogram m_Duration;
+};
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_STATISTICS_H_*/
@@ -0,0 +1,188 @@
+/**
+ * Transaction class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Transaction.h"
+#include "Model.h"
+#include "RuleGraph.h"
+#include "../sync/Synchronized.h"
+#include <algorithm>
+
+namespace de { namespace bswalz { namespace mvc {
+
+thread_local Transaction * Transaction::m_pCurrent = nullptr;
+
+// -------------------------------------------------------
+// Class mvc::Transaction
+// -------------------------------------------------------
+Transaction::Transaction()
+	: m_Entries(), m_Pending(), m_Index(), m_pOuter(m_pCurrent), m_Open(true), m_RollbackOnly(false) {
+	if (m_pOuter == nullptr)
+		m_pCurrent = this;
+}
+
+// -------------------------------------------------------
+Transaction::~Transaction() {
+	if (m_Open)
+		rollback();
+}
+
+// -------------------------------------------------------
+Transaction * Transaction::getCurrent() {
+	return m_pCurrent;
+}
+
+// -------------------------------------------------------
+bool Transaction::enlist(Model * pModel, bool validate) {
+	auto pos = m_Index.find(pModel);
+	if (pos != m_Index.end()) {
+		Entry & entry = m_Entries[pos->second];
+		entry.m_Validate |= validate;
+		if (!entry.m_Pending) {
+			// Assigned again after its AssignRules have been applied. Happens only
+			// with AssignRules which do not declare their targets.
+			schedule(pos->second);
+			}
+		return false;
+		}
+	m_Index[pModel] = m_Entries.size();
+	m_Entries.push_back(Entry{ pModel, validate, false });
+	pModel->m_pTransaction = this; // Other threads cannot assign the model until commit or rollback
+	schedule(m_Entries.size() - 1);
+	return true;
+}
+
+// -------------------------------------------------------
+void Transaction::schedule(size_t index) {
+	m_Entries[index].m_Pending = true;
+	m_Pending.push_back(Pending{ RuleGraph::getRank(m_Entries[index].m_pModel), index });
+	std::push_heap(m_Pending.begin(), m_Pending.end());
+}
+
+// -------------------------------------------------------
+bool Transaction::commit() {
+	if (!m_Open)
+		return false;
+
+	if (m_pOuter != nullptr) {
+		// Nested transaction: the outermost transaction commits
+		m_Open = false;
+		return true;
+		}
+
+	if (m_RollbackOnly) {
+		rollback();
+		return false;
+		}
+
+	// Applies the AssignRules of every touched model once, upstream models first.
+	// Assignments caused by an AssignRule are deferred as well and enlist further models.
+	while (!m_Pending.empty()) {
+		std::pop_heap(m_Pending.begin(), m_Pending.end());
+		const size_t index = m_Pending.back().m_Index;
+		m_Pending.pop_back();
+		m_Entries[index].m_Pending = false;
+
+		Model *        pModel = m_Entries[index].m_pModel;
+		sync::CMutex & mutex  = pModel->getMutex();
+		synchronized(mutex) {
+			pModel->applyAssignRules();
+			}
+		}
+
+	bool valid = !m_RollbackOnly; // Set if an AssignRule could not assign its target
+	for (size_t i = 0; valid && i < m_Entries.size(); i++) {
+		if (m_Entries[i].m_Validate) {
+			Model *        pModel = m_Entries[i].m_pModel;
+			sync::CMutex & mutex  = pModel->getMutex();
+			synchronized(mutex) {
+				valid = pModel->validateAssignment();
+				}
+			}
+		}
+
+	if (!valid) {
+		revertAll();
+		close();
+		return false;
+		}
+
+	for (auto & entry : m_Entries) {
+		sync::CMutex & mutex = entry.m_pModel->getMutex();
+		synchronized(mutex) {
+			entry.m_pModel->commitAssignment();
+			entry.m_pModel->m_pTransaction = nullptr;
+			entry.m_pModel->m_Changed      = true;
+			}
+		}
+
+	// Views are notified outside of the transaction, hence they may assign values
+	std::vector<Entry> entries;
+	entries.swap(m_Entries);
+	close();
+	for (auto & entry : entries) {
+		entry.m_pModel->notifyAll();
+		}
+	return true;
+}
+
+// -------------------------------------------------------
+void Transaction::rollback() {
+	if (!m_Open)
+		return;
+
+	if (m_pOuter != nullptr) {
+		m_pOuter->m_RollbackOnly = true;
+		m_Open = false;
+		return;
+		}
+
+	revertAll();
+	close();
+}
+
+// -------------------------------------------------------
+void Transaction::revertAll() {
+	for (auto pos = m_Entries.rbegin(); pos != m_Entries.rend(); ++pos) {
+		Model *        pModel = pos->m_pModel;
+		sync::CMutex & mutex  = pModel->getMutex();
+		synchronized(mutex) {
+			pModel->revertAssignment();
+			pModel->m_pTransaction = nullptr;
+			}
+		}
+}
+
+// -------------------------------------------------------
+void Transaction::close() {
+	m_Entries.clear();
+	m_Pending.clear();
+	m_Index.clear();
+	m_Open = false;
+	if (m_pCurrent == this)
+		m_pCurrent = nullptr;
+}
+
+}}} // End namespaces
@@ -0,0 +1,133 @@
+#ifndef _DE_BSWALZ_MVC_TRANSACTION_H_
+#define _DE_BSWALZ_MVC_TRANSACTION_H_
+
+/**
+ * Transaction class of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of Transaction
+ * -------------------------------------------------------------------------
+ *	// Bulk assignment: AssignRules, Voters and views see the final state only
+ *	{
+ *		mvc::Transaction transaction;
+ *		m_pGainParameter->assignValue(12);
+ *		m_pBalanceParameter->assignValue(-3);
+ *		...
+ *		if (!transaction.commit()) {
+ *			// All assignments have been reverted, no view has been notified
+ *			}
+ *	} // An uncommitted transaction is rolled back at the end of the scope
+ */
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace de { namespace bswalz { namespace mvc {
+
+class Model;
+
+/**
+ * A Transaction groups the assignments of the current thread to several models.<br>
+ * While the transaction is open, TModel<T>::assignValue only stores the value.
+ * commit() applies the AssignRules of every touched model once, in the topological
+ * order of the RuleGraph, validates every model assigned by the caller once, and
+ * either reverts all assignments or notifies the views of every touched model
+ * exactly once.<br>
+ * Transactions may be nested; the outermost transaction performs the commit.
+ */
+class Transaction {
+public:
+	Transaction();
+	/** Rolls back, if neither commit() nor rollback() has been called */
+	virtual ~Transaction();
+
+	/**
+	 * Commits all assignments of this transaction
+	 * @return true if the validation succeeded. Otherwise all assignments have been reverted
+	 */
+	bool commit();
+
+	/**
+	 * Reverts all assignments of this transaction. No view will be notified.
+	 */
+	void rollback();
+
+	/**
+	 * @return the open transaction of the current thread or nullptr
+	 */
+	static Transaction * getCurrent();
+
+	/**
+	 * Adds a model to the transaction. Called by the assignment of a value with
+	 * locked model. Until commit or rollback the model cannot be assigned by other
+	 * threads, see Model::isAssignable().
+	 * @param pModel the assigned model
+	 * @param validate true if the model has to be validated at commit (i.e. not assigned by an AssignRule)
+	 * @return true if the model is touched the first time within this transaction
+	 */
+	bool enlist(Model * pModel, bool validate);
+
+	/**
+	 * Marks the transaction to be rolled back by commit(). Called if a model
+	 * cannot be assigned since the open transaction of another thread has assigned it.
+	 */
+	void setRollbackOnly() { m_RollbackOnly = true; }
+
+private:
+	Transaction(const Transaction &);
+	Transaction & operator=(const Transaction &);
+
+	struct Entry {
+		Model * m_pModel;
+		bool    m_Validate;
+		bool    m_Pending;      // AssignRules not yet applied
+	};
+
+	// Element of the heap of pending entries, ordered by rank and first touch
+	struct Pending {
+		unsigned int m_Rank;
+		size_t       m_Index;
+		bool operator< (const Pending & r) const {
+			return (m_Rank != r.m_Rank) ? (m_Rank > r.m_Rank) : (m_Index > r.m_Index); }
+	};
+
+	void schedule(size_t index);
+	void revertAll();
+	void close();
+
+	std::vector<Entry>            m_Entries;        // In order of first touch
+	std::vector<Pending>          m_Pending;        // Min-heap by rank
+	std::unordered_map<Model *, size_t> m_Index;    // Index into m_Entries
+	Transaction *                 m_pOuter;
+	bool                          m_Open;
+	bool                          m_RollbackOnly;
+
+	static thread_local Transaction * m_pCurrent;
+}; // End of class Transaction
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_MVC_TRANSACTION_H_*/
@@ -27,12 +27,30 @@
 
 #include "View.h"
 #include "Model.h"
+#include "Anchor.h"
+#include "Executor.h"
+#include "Statistics.h"
+#include <algorithm>
 
 namespace de { namespace bswalz { namespace mvc {
 
+// -----------------------------------------------------
+// Counted reference to the anchor of a view, held by a queued update
+class AnchorReference {
+public:
+	explicit AnchorReference(Anchor * pAnchor) : m_pAnchor(pAnchor) { m_pAnchor->addReference(); }
+	AnchorReference(const AnchorReference & r) : m_pAnchor(r.m_pAnchor) { m_pAnchor->addReference(); }
+	AnchorReference(AnchorReference && r) : m_pAnchor(r.m_pAnchor) { r.m_pAnchor = nullptr; }
+	~AnchorReference() { if (m_pAnchor != nullptr) m_pAnchor->release(); }
+	Anchor * operator->() const { return m_pAnchor; }
+private:
+	AnchorReference & operator=(const AnchorReference &);
+	Anchor * m_pAnchor;
+};
+
 // -----------------------------------------------------
 View::View(Model * pModel)
-	: m_Models() {
+	: m_Models(), m_Sources(), m_pAnchor(new Anchor(this)), m_pExecutor(nullptr), m_pStatistics(nullptr) {
 	if (pModel != nullptr)
 		registerAt(pModel);
 }
@@ -42,16 +60,57 @@ View::~View() {
 	for(auto * pModel : m_Models) {
 		unregisterAt(pModel);
 	}
+	// Discards the queued updates, waits for an update running in the executor
+	m_pAnchor->detach();
+#ifdef DE_BSWALZ_MVC_STATISTICS
+	// After unregistering, no update of this view is measured any more
+	Statistics::getInstance()->removeView(this);
+#endif
 }
 
 // -----------------------------------------------------
 void View::registerAt(Model * pModel, bool initialUpdate) {
-   pModel->registerView(this, initialUpdate);
+	addSource(pModel);
+	pModel->registerView(this, initialUpdate);
 }
 
 // -----------------------------------------------------
 void View::unregisterAt(Model * pModel) {
-   pModel->unregisterView(this);
+	pModel->unregisterView(this);
+	removeSource(pModel);
+}
+
+// -----------------------------------------------------
+void View::addSource(const void * pSource) {
+	sync::CMutex & mutex = m_pAnchor->getMutex();
+	synchronized(mutex) {
+		if (std::find(m_Sources.begin(), m_Sources.end(), pSource) == m_Sources.end())
+			m_Sources.push_back(pSource);
+		}
+}
+
+// -----------------------------------------------------
+void View::removeSource(const void * pSource) {
+	sync::CMutex & mutex = m_pAnchor->getMutex();
+	synchronized(mutex) {
+		// The updates of the registration still queued at the executor are discarded
+		m_Sources.erase(std::remove(m_Sources.begin(), m_Sources.end(), pSource), m_Sources.end());
+		}
+}
+
+// -----------------------------------------------------
+void View::execute(const void * pSource, const Model * pModel, void * pObject) {
+	AnchorReference reference(m_pAnchor);
+	m_pExecutor->execute([anchor = std::move(reference), pSource, pModel, pObject]() {
+		sync::CMutex & mutex = anchor->getMutex();
+		synchronized(mutex) {
+			// Discarded if the view has been deleted or its registration removed meanwhile
+			View * pView = static_cast<View *>(anchor->getOwner());
+			if (pView != nullptr
+			    && std::find(pView->m_Sources.begin(), pView->m_Sources.end(), pSource) != pView->m_Sources.end())
+				Model::deliverUpdate(pView, pModel, pObject);
+			}
+		});
 }
 
 }}} // End namespaces
@@ -27,11 +27,15 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <vector>
 
 namespace de { namespace bswalz { namespace mvc {
 
 class Model;
+class Anchor;
+class IExecutor;
+struct ViewStatistics;
 
 using de::bswalz::mvc::Model;
 
@@ -53,7 +57,9 @@ public:
 	void registerAt(Model * pModel, bool initialUpdate = false);
 	
 	/**
-	 * Unregisters this view at the specified model
+	 * Unregisters this view at the specified model. Returns after all updates
+	 * of this view by the model running in other threads are done.
+	 * @see Model::unregisterView()
 	 * @param pModel the model to be unregistered at
 	 */
 	void unregisterAt(Model * pModel);
@@ -65,12 +71,60 @@ public:
 	 */
 	virtual void update(const Model * pModel, void * pObject) = 0;
 
+	/**
+	 * Sets the executor which delivers the updates of this view, e.g. the queue
+	 * of the thread owning the view. The models post update() to this executor
+	 * instead of calling it, hence a notification in synchronized mode may return
+	 * before the view has been updated.<br>
+	 * A queued update is discarded if the view has been unregistered at the model
+	 * or deleted before the executor runs it. Deleting the view waits for an
+	 * update running in the executor.<br>
+	 * Should be set before registration. The executor has to outlive the view.
+	 * @param pExecutor the executor, nullptr for direct updates (default)
+	 */
+	void setExecutor(IExecutor * pExecutor) { m_pExecutor = pExecutor; }
+
+	/**
+	 * @return the executor of this view or nullptr
+	 */
+	IExecutor * getExecutor() const { return m_pExecutor; }
+
 private:
 	View(const View &);
 	View & operator=(const View &);
 	View & operator=(const View &&);
 
+	friend class Model;
+	friend class Registry;
+	friend class Statistics;
+
+	/**
+	 * Adds the key of a registration, i.e. the model registered at or the
+	 * mvc::RegistryNode of a subscribed prefix. Called before the registration.
+	 * @param pSource the key of the registration
+	 */
+	void addSource(const void * pSource);
+
+	/**
+	 * Removes the key of a registration, the queued updates by the registration
+	 * are discarded. Called after the registration has been removed.
+	 * @param pSource the key of the registration
+	 */
+	void removeSource(const void * pSource);
+
+	/**
+	 * Queues an update at the executor. Called by the notifying model.
+	 * @param pSource the key of the registration which delivers the update
+	 * @param pModel the notifying model
+	 * @param pObject an associated object
+	 */
+	void execute(const void * pSource, const Model * pModel, void * pObject);
+
 	std::vector<Model *> m_Models;
+	std::vector<const void *> m_Sources;   // Keys of the registrations, guarded by the anchor
+	Anchor *             m_pAnchor;        // Counted by the queued updates of the executor
+	IExecutor *          m_pExecutor;
+	mutable std::atomic<ViewStatistics *> m_pStatistics; // Attached by the first measured update, see Statistics
 };
 
 }}} // End namespaces
@@ -0,0 +1,113 @@
+/**
+ * Mutex classes for usage with synchronized(M)
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/sync
+ */
+/*
+ * This file is part of common/sync
+ *
+ * common/sync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mutexes.h"
+#include <thread>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace de { namespace bswalz { namespace sync {
+
+// Hints the CPU that the thread is spinning
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield");
+#endif
+}
+
+// -------------------------------------------------------
+// Class sync::CSpinMutex
+// -------------------------------------------------------
+void CSpinMutex::lockContended() {
+	unsigned int backoff = 1;
+	for (;;) {
+		// Spins on a load, the cache line is shared until the lock is released
+		while (m_Locked.load(std::memory_order_relaxed)) {
+			if (backoff <= 64) {
+				for (unsigned int i = 0; i < backoff; i++) {
+					cpuRelax();
+					}
+				backoff <<= 1;
+				}
+			else
+				std::this_thread::yield(); // The owner may wait for this CPU
+			}
+		if (!m_Locked.exchange(true, std::memory_order_acquire))
+			return;
+		}
+}
+
+// -------------------------------------------------------
+// Class sync::CAdaptiveMutex
+// -------------------------------------------------------
+void CAdaptiveMutex::lockContended() {
+	for (unsigned int i = 0; i < SPIN_COUNT; i++) {
+		int state = m_State.load(std::memory_order_relaxed);
+		if (state == UNLOCKED) {
+			if (m_State.compare_exchange_weak(state, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+				return;
+			}
+		else if (state == PARKED)
+			break; // Others are sleeping already, spinning is in vain
+		cpuRelax();
+		}
+	// Locked as PARKED, since other threads may have been parked meanwhile
+	while (m_State.exchange(PARKED, std::memory_order_acquire) != UNLOCKED) {
+		park();
+		}
+}
+
+#if defined(__linux__)
+// -------------------------------------------------------
+void CAdaptiveMutex::park() {
+	// Returns immediately if the state is not PARKED anymore
+	syscall(SYS_futex, reinterpret_cast<int *>(&m_State), FUTEX_WAIT_PRIVATE, static_cast<int>(PARKED), nullptr, nullptr, 0);
+}
+
+// -------------------------------------------------------
+void CAdaptiveMutex::wake() {
+	syscall(SYS_futex, reinterpret_cast<int *>(&m_State), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+#else
+// -------------------------------------------------------
+void CAdaptiveMutex::park() {
+	std::unique_lock<std::mutex> lock(m_ParkMutex);
+	m_Parked.wait(lock, [this]() { return m_State.load(std::memory_order_relaxed) != PARKED; });
+}
+
+// -------------------------------------------------------
+void CAdaptiveMutex::wake() {
+	std::lock_guard<std::mutex> lock(m_ParkMutex);
+	m_Parked.notify_one();
+}
+#endif
+
+}}} // End namespaces
@@ -0,0 +1,138 @@
+#ifndef _DE_BSWALZ_SYNC_MUTEXES_H_
+#define _DE_BSWALZ_SYNC_MUTEXES_H_
+
+/**
+ * Mutex classes for usage with synchronized(M)
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/sync
+ */
+/*
+ * This file is part of common/sync
+ *
+ * common/sync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of the mutex classes
+ * -------------------------------------------------------------------------
+ *	// The type of the member selects the locking policy, the call sites keep their syntax
+ *	sync::CAdaptiveMutex m_StatsMutex;
+ *	...
+ *	synchronized(m_StatsMutex) {
+ *		m_Count++;
+ *		}
+ *
+ *	The mutexes of this file are not recursive, a thread must not lock them twice.
+ *	CMutex remains the choice for code which locks recursively, e.g. the models.
+ */
+
+#include <atomic>
+#include <mutex>
+#if !defined(__linux__)
+#include <condition_variable>
+#endif
+
+namespace de { namespace bswalz { namespace sync {
+
+/**
+ * The CPlainMutex class specifies a non-recursive mutex, on Linux a futex
+ * based pthread mutex. Without owner bookkeeping it is cheaper than CMutex.
+ */
+class CPlainMutex : public std::mutex {
+public:
+	CPlainMutex() : std::mutex() {}
+private:
+	CPlainMutex(const CPlainMutex &);
+	CPlainMutex & operator=(const CPlainMutex &);
+};
+
+/**
+ * The CSpinMutex class specifies a non-recursive spin lock with exponential
+ * backoff. A waiting thread never sleeps, it yields its time slice after some
+ * rounds of backoff. For critical sections of a few instructions only.
+ */
+class CSpinMutex {
+public:
+	CSpinMutex() : m_Locked(false) {}
+	/** Locks a thread to protect critical regions */
+	void lock() {
+		if (!m_Locked.exchange(true, std::memory_order_acquire))
+			return;
+		lockContended();
+	}
+	/** @return true if the lock has been acquired without waiting */
+	bool try_lock() {
+		return !m_Locked.load(std::memory_order_relaxed) && !m_Locked.exchange(true, std::memory_order_acquire);
+	}
+	/** Unlocks a thread after protection of critical regions */
+	void unlock() { m_Locked.store(false, std::memory_order_release); }
+private:
+	CSpinMutex(const CSpinMutex &);
+	CSpinMutex & operator=(const CSpinMutex &);
+
+	void lockContended();
+
+	std::atomic<bool> m_Locked;
+};
+
+/**
+ * The CAdaptiveMutex class specifies a non-recursive mutex which spins for a
+ * short time and parks the waiting thread afterwards, on Linux by a futex.
+ * Short critical sections are handed over without a system call, long ones
+ * do not burn the CPU of the waiting threads.
+ */
+class CAdaptiveMutex {
+public:
+	CAdaptiveMutex() : m_State(UNLOCKED) {}
+	/** Locks a thread to protect critical regions */
+	void lock() {
+		int expected = UNLOCKED;
+		if (m_State.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+			return;
+		lockContended();
+	}
+	/** @return true if the lock has been acquired without waiting */
+	bool try_lock() {
+		int expected = UNLOCKED;
+		return m_State.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+	/** Unlocks a thread after protection of critical regions */
+	void unlock() {
+		if (m_State.exchange(UNLOCKED, std::memory_order_release) == PARKED)
+			wake();
+	}
+private:
+	CAdaptiveMutex(const CAdaptiveMutex &);
+	CAdaptiveMutex & operator=(const CAdaptiveMutex &);
+
+	enum { UNLOCKED = 0, LOCKED = 1, PARKED = 2 };  // PARKED: locked, threads may sleep
+	static const unsigned int SPIN_COUNT = 100;
+
+	void lockContended();
+	void park();
+	void wake();
+
+	std::atomic<int>        m_State;
+#if !defined(__linux__)
+	std::mutex              m_ParkMutex;
+	std::condition_variable m_Parked;
+#endif
+};
+
+}}} // End namespaces
+
+#endif /*_DE_BSWALZ_SYNC_MUTEXES_H_*/
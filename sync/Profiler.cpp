@@ -0,0 +1,243 @@
+/**
+ * Lock contention profiler for usage with synchronized(M)
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/sync
+ */
+/*
+ * This file is part of common/sync
+ *
+ * common/sync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+#include <algorithm>
+
+namespace de { namespace bswalz { namespace sync {
+
+// -------------------------------------------------------
+// Class sync::Profiler::Histogram
+// -------------------------------------------------------
+Profiler::Histogram::Histogram()
+	: m_Count(0), m_Total(0), m_Max(0) {
+	for (auto & bucket : m_Buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+		}
+}
+
+// -------------------------------------------------------
+void Profiler::Histogram::add(uint64_t ns) {
+	unsigned int bucket = 0;
+	while (bucket < BUCKETS - 1 && (ns >> (bucket + 1)) != 0)
+		bucket++;
+	m_Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	m_Count.fetch_add(1, std::memory_order_relaxed);
+	m_Total.fetch_add(ns, std::memory_order_relaxed);
+	uint64_t max = m_Max.load(std::memory_order_relaxed);
+	while (ns > max && !m_Max.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+		;
+}
+
+// -------------------------------------------------------
+void Profiler::Histogram::add(const Histogram & r) {
+	for (unsigned int i = 0; i < BUCKETS; i++) {
+		m_Buckets[i].fetch_add(r.m_Buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	m_Count.fetch_add(r.getCount(), std::memory_order_relaxed);
+	m_Total.fetch_add(r.getTotal(), std::memory_order_relaxed);
+	const uint64_t ns = r.getMax();
+	uint64_t max = m_Max.load(std::memory_order_relaxed);
+	while (ns > max && !m_Max.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+		;
+}
+
+// -------------------------------------------------------
+void Profiler::Histogram::reset() {
+	for (auto & bucket : m_Buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+		}
+	m_Count.store(0, std::memory_order_relaxed);
+	m_Total.store(0, std::memory_order_relaxed);
+	m_Max.store(0, std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------
+uint64_t Profiler::Histogram::getPercentile(double p) const {
+	const uint64_t rank = static_cast<uint64_t>(p * getCount());
+	uint64_t count = 0;
+	for (unsigned int i = 0; i < BUCKETS; i++) {
+		count += m_Buckets[i].load(std::memory_order_relaxed);
+		if (count > rank)
+			return std::min(getMax(), (uint64_t(2) << i) - 1);
+		}
+	return getMax();
+}
+
+// -------------------------------------------------------
+// Class sync::Profiler::LockStats
+// -------------------------------------------------------
+void Profiler::LockStats::add(bool contended, uint64_t waitNs, uint64_t holdNs) {
+	m_Acquisitions.fetch_add(1, std::memory_order_relaxed);
+	if (contended) {
+		m_Contended.fetch_add(1, std::memory_order_relaxed);
+		m_Wait.add(waitNs);
+		}
+	m_Hold.add(holdNs);
+}
+
+// -------------------------------------------------------
+void Profiler::LockStats::add(const LockStats & r) {
+	m_Acquisitions.fetch_add(r.m_Acquisitions.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	m_Contended.fetch_add(r.m_Contended.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	m_Wait.add(r.m_Wait);
+	m_Hold.add(r.m_Hold);
+}
+
+// -------------------------------------------------------
+void Profiler::LockStats::reset() {
+	m_Acquisitions.store(0, std::memory_order_relaxed);
+	m_Contended.store(0, std::memory_order_relaxed);
+	m_Wait.reset();
+	m_Hold.reset();
+}
+
+// -------------------------------------------------------
+// Class sync::Profiler::CallSite
+// -------------------------------------------------------
+Profiler::CallSite::CallSite(const char * pFile, int line, const char * pMutex)
+	: LockStats(), m_pFile(pFile), m_Line(line), m_pMutex(pMutex) {
+	Profiler::getInstance()->addCallSite(this);
+}
+
+// -------------------------------------------------------
+// Class sync::Profiler
+// -------------------------------------------------------
+Profiler * Profiler::getInstance() {
+	// Never destroyed: locks may be taken during static destruction
+	static Profiler * pInstance = new Profiler();
+	return pInstance;
+}
+
+// -------------------------------------------------------
+bool Profiler::isEnabled() {
+#ifdef DE_BSWALZ_SYNC_PROFILING
+	return true;
+#else
+	return false;
+#endif
+}
+
+// -------------------------------------------------------
+Profiler::LockStats * Profiler::getMutexStats(const std::string & name) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	std::unique_ptr<LockStats> & upStats = m_Names[name];
+	if (upStats.get() == nullptr)
+		upStats.reset(new LockStats());
+	return upStats.get();
+}
+
+// -------------------------------------------------------
+void Profiler::addCallSite(CallSite * pSite) {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_CallSites.push_back(pSite);
+}
+
+// -------------------------------------------------------
+// Writes a line of the report
+static void dumpStats(std::ostream & os, const std::string & label, const Profiler::LockStats & stats) {
+	const uint64_t acquisitions = stats.m_Acquisitions.load(std::memory_order_relaxed);
+	const uint64_t contended    = stats.m_Contended.load(std::memory_order_relaxed);
+	os << "    " << label << ": " << acquisitions << " acquisitions, " << contended << " contended";
+	if (acquisitions > 0)
+		os << " (" << (100 * contended / acquisitions) << "%)";
+	os << ", wait [ns] total " << stats.m_Wait.getTotal() << " p99 " << stats.m_Wait.getPercentile(0.99)
+	   << " max " << stats.m_Wait.getMax()
+	   << ", hold [ns] p50 " << stats.m_Hold.getPercentile(0.5) << " p99 " << stats.m_Hold.getPercentile(0.99)
+	   << " max " << stats.m_Hold.getMax() << std::endl;
+}
+
+// -------------------------------------------------------
+void Profiler::dump(std::ostream & os, size_t n) const {
+	if (!isEnabled()) {
+		os << "sync::Profiler: not compiled in, define DE_BSWALZ_SYNC_PROFILING" << std::endl;
+		return;
+		}
+
+	// Call sites merged by file, line and expression
+	std::map<std::string, std::unique_ptr<LockStats>> merged;
+	std::vector<std::pair<std::string, const LockStats *>> sites;
+	std::vector<std::pair<std::string, const LockStats *>> names;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (auto pSite : m_CallSites) {
+			std::unique_ptr<LockStats> & upStats = merged[std::string(pSite->m_pFile) + ":"
+				+ std::to_string(pSite->m_Line) + " synchronized(" + pSite->m_pMutex + ")"];
+			if (upStats.get() == nullptr)
+				upStats.reset(new LockStats());
+			upStats->add(*pSite);
+			}
+		for (auto & name : m_Names) {
+			names.push_back(std::make_pair(name.first, name.second.get()));
+			}
+	}
+	for (auto & site : merged) {
+		sites.push_back(std::make_pair(site.first, site.second.get()));
+		}
+	auto byWait = [](const LockStats * pA, const LockStats * pB) {
+		return pA->m_Wait.getTotal() > pB->m_Wait.getTotal()
+		    || (pA->m_Wait.getTotal() == pB->m_Wait.getTotal()
+		        && pA->m_Acquisitions.load(std::memory_order_relaxed) > pB->m_Acquisitions.load(std::memory_order_relaxed)); };
+	auto byWaitOfPair = [&byWait](const std::pair<std::string, const LockStats *> & a,
+	                              const std::pair<std::string, const LockStats *> & b) {
+		return byWait(a.second, b.second); };
+	std::sort(sites.begin(), sites.end(), byWaitOfPair);
+	std::sort(names.begin(), names.end(), byWaitOfPair);
+
+	os << "sync::Profiler" << std::endl << "  call sites:" << std::endl;
+	for (size_t i = 0; i < sites.size() && i < n; i++) {
+		dumpStats(os, sites[i].first, *sites[i].second);
+		}
+	os << "  mutexes:" << std::endl;
+	for (size_t i = 0; i < names.size() && i < n; i++) {
+		dumpStats(os, names[i].first, *names[i].second);
+		}
+}
+
+// -------------------------------------------------------
+void Profiler::reset() {
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (auto pSite : m_CallSites) {
+		pSite->reset();
+		}
+	for (auto & name : m_Names) {
+		name.second->reset();
+		}
+}
+
+// -------------------------------------------------------
+// Class sync::LockProbe
+// -------------------------------------------------------
+void LockProbe::record(std::chrono::steady_clock::duration hold, Profiler::LockStats * pMutexStats, Profiler::LockStats * pSiteStats) {
+	const uint64_t waitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(m_Wait).count();
+	const uint64_t holdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(hold).count();
+	if (pMutexStats != nullptr)
+		pMutexStats->add(m_Contended, waitNs, holdNs);
+	if (pSiteStats != nullptr)
+		pSiteStats->add(m_Contended, waitNs, holdNs);
+}
+
+}}} // End namespaces
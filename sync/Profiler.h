@@ -0,0 +1,209 @@
+#ifndef _DE_BSWALZ_SYNC_PROFILER_H_
+#define _DE_BSWALZ_SYNC_PROFILER_H_
+
+/**
+ * Lock contention profiler for usage with synchronized(M)
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/sync
+ */
+/*
+ * This file is part of common/sync
+ *
+ * common/sync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of Profiler
+ * -------------------------------------------------------------------------
+ *	// The locks are profiled only if the whole build defines
+ *	// DE_BSWALZ_SYNC_PROFILING (e.g. -DDE_BSWALZ_SYNC_PROFILING), otherwise
+ *	// synchronized(M) and the lockers contain no instrumentation at all.
+ *	m_Mutex.setName("audio.mixer");       // Optional, aggregates the mutexes of this name
+ *	...
+ *	if (sync::Profiler::isEnabled())
+ *		sync::Profiler::getInstance()->dump(std::cerr, 10); // The 10 most contended
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace de { namespace bswalz { namespace sync {
+
+/**
+ * Collects the acquisitions, contended acquisitions, wait and hold times of
+ * locks, per call site of synchronized(M) and per mutex name.<br>
+ * Recording is lock-free, the counters are atomic.
+ */
+class Profiler {
+public:
+	/**
+	 * Histogram of durations in nanoseconds with logarithmic buckets.<br>
+	 * Bucket i counts the durations in [2^i, 2^(i+1)), bucket 0 includes 0.
+	 */
+	struct Histogram {
+		static const unsigned int BUCKETS = 40;
+
+		Histogram();
+		void     add(uint64_t ns);
+		void     add(const Histogram & r);
+		void     reset();
+		/** @return the number of durations */
+		uint64_t getCount() const { return m_Count.load(std::memory_order_relaxed); }
+		/** @return the sum of the durations in ns */
+		uint64_t getTotal() const { return m_Total.load(std::memory_order_relaxed); }
+		/** @return the maximum duration in ns */
+		uint64_t getMax() const { return m_Max.load(std::memory_order_relaxed); }
+		/** @return the upper bound of the bucket containing the percentile (0.0 .. 1.0) */
+		uint64_t getPercentile(double p) const;
+
+		std::atomic<uint64_t> m_Buckets[BUCKETS];
+		std::atomic<uint64_t> m_Count;
+		std::atomic<uint64_t> m_Total;
+		std::atomic<uint64_t> m_Max;
+	};
+
+	/** The statistics of a mutex name or a call site */
+	struct LockStats {
+		LockStats() : m_Acquisitions(0), m_Contended(0) {}
+		/** Adds an acquisition, the wait time is 0 if not contended */
+		void     add(bool contended, uint64_t waitNs, uint64_t holdNs);
+		void     add(const LockStats & r);
+		void     reset();
+
+		std::atomic<uint64_t> m_Acquisitions;
+		std::atomic<uint64_t> m_Contended;    // The mutex had been locked by another thread
+		Histogram             m_Wait;         // Contended acquisitions only
+		Histogram             m_Hold;
+	};
+
+	/** A call site of synchronized(M), registered at its first execution */
+	struct CallSite : public LockStats {
+		CallSite(const char * pFile, int line, const char * pMutex);
+
+		const char * m_pFile;
+		int          m_Line;
+		const char * m_pMutex;  // The expression M
+	};
+
+	/**
+	 * @return the profiler instance
+	 */
+	static Profiler * getInstance();
+
+	/**
+	 * @return true if the profiler is compiled in (DE_BSWALZ_SYNC_PROFILING)
+	 */
+	static bool isEnabled();
+
+	/**
+	 * @param name the name of a mutex
+	 * @return the statistics of the name, shared by all mutexes of this name
+	 */
+	LockStats * getMutexStats(const std::string & name);
+
+	/**
+	 * Writes a human readable report, call sites and names ordered by total wait time.
+	 * The call sites of a template are merged over its instantiations.
+	 * @param os the output stream
+	 * @param n the number of call sites and names to be listed
+	 */
+	void dump(std::ostream & os, size_t n) const;
+
+	/**
+	 * Clears the recorded statistics, the call sites and names are kept
+	 */
+	void reset();
+
+private:
+	Profiler() {}
+	Profiler(const Profiler &);
+	Profiler & operator=(const Profiler &);
+
+	void addCallSite(CallSite * pSite);
+
+	std::map<std::string, std::unique_ptr<LockStats>> m_Names;   // Never removed, mutexes keep pointers
+	std::vector<CallSite *>                           m_CallSites;
+	mutable std::mutex                                m_Mutex;
+}; // End of class Profiler
+
+/**
+ * Measures a single acquisition, used by the lockers
+ */
+class LockProbe {
+public:
+	/** Locks the mutex exclusive */
+	template <class M> void lock(M & mutex) {
+		m_Contended = !mutex.try_lock();
+		if (m_Contended) {
+			const auto start = std::chrono::steady_clock::now();
+			mutex.lock();
+			m_Locked = std::chrono::steady_clock::now();
+			m_Wait   = m_Locked - start;
+			}
+		else
+			m_Locked = std::chrono::steady_clock::now();
+	}
+
+	/** Locks the mutex shared */
+	template <class M> void lockShared(M & mutex) {
+		m_Contended = !mutex.try_lock_shared();
+		if (m_Contended) {
+			const auto start = std::chrono::steady_clock::now();
+			mutex.lock_shared();
+			m_Locked = std::chrono::steady_clock::now();
+			m_Wait   = m_Locked - start;
+			}
+		else
+			m_Locked = std::chrono::steady_clock::now();
+	}
+
+	/** Unlocks the mutex exclusive and records the acquisition */
+	template <class M> void unlock(M & mutex, Profiler::LockStats * pMutexStats, Profiler::LockStats * pSiteStats) {
+		const auto hold = std::chrono::steady_clock::now() - m_Locked;
+		mutex.unlock();
+		record(hold, pMutexStats, pSiteStats);
+	}
+
+	/** Unlocks the mutex shared and records the acquisition */
+	template <class M> void unlockShared(M & mutex, Profiler::LockStats * pMutexStats, Profiler::LockStats * pSiteStats) {
+		const auto hold = std::chrono::steady_clock::now() - m_Locked;
+		mutex.unlock_shared();
+		record(hold, pMutexStats, pSiteStats);
+	}
+
+private:
+	void record(std::chrono::steady_clock::duration hold, Profiler::LockStats * pMutexStats, Profiler::LockStats * pSiteStats);
+
+	bool                                  m_Contended = false;
+	std::chrono::steady_clock::duration   m_Wait      = std::chrono::steady_clock::duration::zero();
+	std::chrono::steady_clock::time_point m_Locked;
+}; // End of class LockProbe
+
+/** @return the statistics of a mutex, nullptr for mutexes without a name */
+template <class M> inline Profiler::LockStats * getLockStats(const M &) { return nullptr; }
+
+}}} // End namespaces
+
+#endif /*_DE_BSWALZ_SYNC_PROFILER_H_*/
@@ -0,0 +1,92 @@
+/**
+ * Lock-free bounded queues for the handoff between threads
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/sync
+ */
+/*
+ * This file is part of common/sync
+ *
+ * common/sync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Queues.h"
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace de { namespace bswalz { namespace sync {
+
+// -------------------------------------------------------
+// Class CEventCount
+// -------------------------------------------------------
+uint32_t CEventCount::prepareWait() {
+	// The key changes with the next notifyAll(), even if another waiter has set the bit before.
+	// A cancelled wait leaves the bit set, costing one needless wake-up at most.
+	const uint32_t key = m_State.fetch_or(1, std::memory_order_relaxed) | 1;
+	// Pairs with the fence of notifyAll(): either the waiter sees the changed
+	// condition or the notifier sees the bit
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	return key;
+}
+
+// -------------------------------------------------------
+// @return true if the state changed from a waited for one to a new epoch
+static inline bool advanceEpoch(std::atomic<uint32_t> & state) {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	uint32_t current = state.load(std::memory_order_relaxed);
+	if ((current & 1) == 0)
+		return false;
+	// Fails only if a concurrent notifyAll() has advanced the epoch, it wakes up the waiters
+	return state.compare_exchange_strong(current, (current & ~1u) + 2, std::memory_order_release, std::memory_order_relaxed);
+}
+
+#if defined(__linux__)
+// -------------------------------------------------------
+void CEventCount::wait(uint32_t key) {
+	// Returns immediately if notifyAll() has advanced the epoch since prepareWait()
+	while (m_State.load(std::memory_order_acquire) == key) {
+		syscall(SYS_futex, reinterpret_cast<int *>(&m_State), FUTEX_WAIT_PRIVATE, static_cast<int>(key), nullptr, nullptr, 0);
+		}
+}
+
+// -------------------------------------------------------
+void CEventCount::notifyAll() {
+	if (advanceEpoch(m_State))
+		syscall(SYS_futex, reinterpret_cast<int *>(&m_State), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+#else
+// -------------------------------------------------------
+void CEventCount::wait(uint32_t key) {
+	std::unique_lock<std::mutex> lock(m_WaitMutex);
+	m_Condition.wait(lock, [this, key]() { return m_State.load(std::memory_order_acquire) != key; });
+}
+
+// -------------------------------------------------------
+void CEventCount::notifyAll() {
+	if (advanceEpoch(m_State)) {
+		// Locked, a waiter is either before its check or within wait()
+		{ std::lock_guard<std::mutex> lock(m_WaitMutex); }
+		m_Condition.notify_all();
+		}
+}
+#endif
+
+}}} // End namespaces
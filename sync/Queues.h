@@ -0,0 +1,600 @@
+#ifndef _DE_BSWALZ_SYNC_QUEUES_H_
+#define _DE_BSWALZ_SYNC_QUEUES_H_
+
+/**
+ * Lock-free bounded queues for the handoff between threads
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/sync
+ */
+/*
+ * This file is part of common/sync
+ *
+ * common/sync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of the queues
+ * -------------------------------------------------------------------------
+ *	sync::TMpscQueue<Sample *> m_Queue(1024);
+ *
+ *	// Any number of producers
+ *	if (!m_Queue.tryPush(pSample))
+ *		m_Overflows++;                      // Or m_Queue.push(pSample) to wait for space
+ *
+ *	// The single consumer thread takes what is there, at least one
+ *	Sample * samples[64];
+ *	while (size_t count = m_Queue.pop(samples, 64)) {
+ *		for (size_t i = 0; i < count; i++) process(samples[i]);
+ *		}
+ *	// pop() returns 0 after m_Queue.close() once the queue is drained
+ *
+ *	TSpscQueue has the same interface for one producer and one consumer thread.
+ *	Blocking and non-blocking calls may be mixed, a waiting thread is woken up
+ *	by any push or pop of the other side.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#if !defined(__linux__)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace de { namespace bswalz { namespace sync {
+
+/**
+ * The CEventCount class lets a thread wait for a condition which is changed
+ * without any lock, on Linux by a futex. notifyAll() costs a fence and a load
+ * as long as no thread waits, and wakes the waiting threads by one system call
+ * only, even if it is called again before they run. A waiting thread follows
+ * the protocol:<br>
+ * key = prepareWait(); if (condition) cancelWait(); else wait(key);
+ */
+class alignas(64) CEventCount {
+public:
+	CEventCount() : m_State(0) {}
+
+	/**
+	 * Announces a waiting thread, the condition has to be checked afterwards
+	 * @return the key for wait()
+	 */
+	uint32_t prepareWait();
+
+	/** Withdraws prepareWait(), if the condition is already met */
+	void cancelWait() {}
+
+	/**
+	 * Blocks until notifyAll() has been called after prepareWait()
+	 * @param key the key of prepareWait()
+	 */
+	void wait(uint32_t key);
+
+	/** Wakes up all waiting threads, called after the condition has changed */
+	void notifyAll();
+
+private:
+	CEventCount(const CEventCount &);
+	CEventCount & operator=(const CEventCount &);
+
+	// Bit 0 is set by prepareWait(), the epoch above is incremented by the notifyAll()
+	// which finds it set and clears it in the same step
+	std::atomic<uint32_t>   m_State;
+#if !defined(__linux__)
+	std::mutex              m_WaitMutex;
+	std::condition_variable m_Condition;
+#endif
+};
+
+/**
+ * Template class TSpscQueue, a bounded ring for one producer and one consumer thread.<br>
+ * The producer and the consumer index are on cache lines of their own, each side
+ * keeps a copy of the other side's index and reads the shared one only if the
+ * copy says full or empty. A push or pop without waiting threads performs no
+ * atomic read-modify-write operation.
+ */
+template <typename T> class TSpscQueue {
+public:
+	/**
+	 * @param capacity the number of elements, rounded up to a power of two
+	 */
+	explicit TSpscQueue(size_t capacity);
+
+	/**
+	 * Appends an element, called by the producer only
+	 * @return false if the queue is full
+	 */
+	bool tryPush(T value);
+
+	/**
+	 * Appends up to count elements, called by the producer only
+	 * @param pValues the elements, moved into the queue
+	 * @param count the number of elements
+	 * @return the number of elements appended, 0 if the queue is full
+	 */
+	size_t tryPush(T * pValues, size_t count);
+
+	/**
+	 * Appends an element, waits while the queue is full. Called by the producer only
+	 * @return false if the queue has been closed
+	 */
+	bool push(T value);
+
+	/**
+	 * Removes the oldest element, called by the consumer only
+	 * @return false if the queue is empty
+	 */
+	bool tryPop(T & value);
+
+	/**
+	 * Removes up to max elements, called by the consumer only
+	 * @param pValues receives the elements, oldest first
+	 * @param max the maximum number of elements
+	 * @return the number of elements removed, 0 if the queue is empty
+	 */
+	size_t tryPop(T * pValues, size_t max);
+
+	/**
+	 * Removes the oldest element, waits while the queue is empty. Called by the consumer only
+	 * @return false if the queue has been closed and is empty
+	 */
+	bool pop(T & value);
+
+	/**
+	 * Removes up to max elements, waits while the queue is empty. Called by the consumer only
+	 * @return the number of elements removed, 0 if the queue has been closed and is empty
+	 */
+	size_t pop(T * pValues, size_t max);
+
+	/** Wakes up the waiting threads, push() fails and pop() drains the queue afterwards */
+	void close();
+
+	/** @return true if close() has been called */
+	bool isClosed() const { return m_Closed.load(std::memory_order_acquire); }
+
+	/** @return the number of queued elements, a snapshot only */
+	size_t size() const;
+
+	/** @return the number of elements the queue keeps */
+	size_t getCapacity() const { return m_Mask + 1; }
+
+private:
+	TSpscQueue(const TSpscQueue &);
+	TSpscQueue & operator=(const TSpscQueue &);
+
+	// Written by the consumer
+	alignas(64) std::atomic<size_t> m_Head;
+	size_t                          m_CachedTail;
+	// Written by the producer
+	alignas(64) std::atomic<size_t> m_Tail;
+	size_t                          m_CachedHead;
+	// Read-only after construction
+	alignas(64) std::unique_ptr<T[]> m_upSlots;
+	size_t                          m_Mask;
+	std::atomic<bool>               m_Closed;
+	CEventCount                     m_NotEmpty;
+	CEventCount                     m_NotFull;
+}; // End of template <class T> TSpscQueue
+
+/**
+ * Template class TMpscQueue, a bounded ring for any number of producers and one
+ * consumer thread.<br>
+ * Every slot carries a sequence number which tells the producers whether the slot
+ * is free and the consumer whether it is filled. A producer claims slots by a
+ * compare-and-swap of the producer index, a batch claims all its slots at once.
+ * The consumer writes its index once per tryPop().<br>
+ * close() sets a bit of the producer index, hence a producer either claims its
+ * slots before the close or fails, and the consumer knows the final index.
+ */
+template <typename T> class TMpscQueue {
+public:
+	/**
+	 * @param capacity the number of elements, rounded up to a power of two
+	 */
+	explicit TMpscQueue(size_t capacity);
+
+	/**
+	 * Appends an element, called by any thread
+	 * @return false if the queue is full or has been closed
+	 */
+	bool tryPush(T value);
+
+	/**
+	 * Appends up to count elements in a row, called by any thread
+	 * @param pValues the elements, moved into the queue
+	 * @param count the number of elements
+	 * @return the number of elements appended, 0 if the queue is full or has been closed
+	 */
+	size_t tryPush(T * pValues, size_t count);
+
+	/**
+	 * Appends an element, waits while the queue is full. Called by any thread
+	 * @return false if the queue has been closed
+	 */
+	bool push(T value);
+
+	/**
+	 * Removes the oldest element, called by the consumer only
+	 * @return false if the queue is empty
+	 */
+	bool tryPop(T & value);
+
+	/**
+	 * Removes up to max elements, called by the consumer only
+	 * @param pValues receives the elements, oldest first
+	 * @param max the maximum number of elements
+	 * @return the number of elements removed, 0 if the queue is empty
+	 */
+	size_t tryPop(T * pValues, size_t max);
+
+	/**
+	 * Removes the oldest element, waits while the queue is empty. Called by the consumer only
+	 * @return false if the queue has been closed and is empty
+	 */
+	bool pop(T & value);
+
+	/**
+	 * Removes up to max elements, waits while the queue is empty. Called by the consumer only
+	 * @return the number of elements removed, 0 if the queue has been closed and is empty
+	 */
+	size_t pop(T * pValues, size_t max);
+
+	/**
+	 * Wakes up the waiting threads, every push fails and pop() drains the queue
+	 * afterwards. An element is either appended before the close or rejected.
+	 */
+	void close();
+
+	/** @return true if close() has been called */
+	bool isClosed() const { return (m_Tail.load(std::memory_order_acquire) & CLOSED) != 0; }
+
+	/** @return the number of queued elements, a snapshot only */
+	size_t size() const;
+
+	/** @return the number of elements the queue keeps */
+	size_t getCapacity() const { return m_Mask + 1; }
+
+private:
+	TMpscQueue(const TMpscQueue &);
+	TMpscQueue & operator=(const TMpscQueue &);
+
+	static const size_t CLOSED = ~(~size_t(0) >> 1);  // The bit of m_Tail set by close()
+
+	struct Slot {
+		std::atomic<size_t> m_Sequence;  // Index + 1 if filled, index if free for the lap of index
+		T                   m_Value;
+	};
+
+	/** Moves value into the queue if there is a free slot */
+	bool pushOne(T & value);
+
+	// Written by the consumer
+	alignas(64) std::atomic<size_t> m_Head;
+	// Written by the producers and by close(), see CLOSED
+	alignas(64) std::atomic<size_t> m_Tail;
+	// Read-only after construction
+	alignas(64) std::unique_ptr<Slot[]> m_upSlots;
+	size_t                          m_Mask;
+	CEventCount                     m_NotEmpty;
+	CEventCount                     m_NotFull;
+}; // End of template <class T> TMpscQueue
+
+
+// -------------------------------------------------------
+// Helpers of the queues
+// -------------------------------------------------------
+// @return capacity rounded up to a power of two, at least 2
+inline size_t roundUpCapacity(size_t capacity) {
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+	return size;
+}
+
+// -------------------------------------------------------
+// Template class TSpscQueue<T>
+// -------------------------------------------------------
+template <typename T>
+TSpscQueue<T>::TSpscQueue(size_t capacity)
+	: m_Head(0), m_CachedTail(0), m_Tail(0), m_CachedHead(0),
+	  m_upSlots(new T[roundUpCapacity(capacity)]), m_Mask(roundUpCapacity(capacity) - 1), m_Closed(false),
+	  m_NotEmpty(), m_NotFull() {
+	// Intentionally left blank
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TSpscQueue<T>::tryPush(T value) {
+	return tryPush(&value, 1) == 1;
+};
+
+// -------------------------------------------------------
+template <typename T>
+size_t TSpscQueue<T>::tryPush(T * pValues, size_t count) {
+	const size_t tail = m_Tail.load(std::memory_order_relaxed);
+	if (tail + count - m_CachedHead > m_Mask + 1)
+		m_CachedHead = m_Head.load(std::memory_order_acquire);
+	const size_t free = m_Mask + 1 - (tail - m_CachedHead);
+	if (count > free)
+		count = free;
+	if (count == 0)
+		return 0;
+	for (size_t i = 0; i < count; i++) {
+		m_upSlots[(tail + i) & m_Mask] = std::move(pValues[i]);
+		}
+	m_Tail.store(tail + count, std::memory_order_release);
+	m_NotEmpty.notifyAll();
+	return count;
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TSpscQueue<T>::push(T value) {
+	for (;;) {
+		if (m_Closed.load(std::memory_order_acquire))
+			return false;
+		if (tryPush(&value, 1) == 1)
+			return true;
+		const uint32_t key = m_NotFull.prepareWait();
+		if (m_Closed.load(std::memory_order_acquire)) {
+			m_NotFull.cancelWait();
+			return false;
+			}
+		if (tryPush(&value, 1) == 1) {
+			m_NotFull.cancelWait();
+			return true;
+			}
+		m_NotFull.wait(key);
+		}
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TSpscQueue<T>::tryPop(T & value) {
+	return tryPop(&value, 1) == 1;
+};
+
+// -------------------------------------------------------
+template <typename T>
+size_t TSpscQueue<T>::tryPop(T * pValues, size_t max) {
+	const size_t head = m_Head.load(std::memory_order_relaxed);
+	if (m_CachedTail - head < max)
+		m_CachedTail = m_Tail.load(std::memory_order_acquire);
+	size_t count = m_CachedTail - head;
+	if (count > max)
+		count = max;
+	if (count == 0)
+		return 0;
+	for (size_t i = 0; i < count; i++) {
+		pValues[i] = std::move(m_upSlots[(head + i) & m_Mask]);
+		}
+	m_Head.store(head + count, std::memory_order_release);
+	m_NotFull.notifyAll();
+	return count;
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TSpscQueue<T>::pop(T & value) {
+	return pop(&value, 1) == 1;
+};
+
+// -------------------------------------------------------
+template <typename T>
+size_t TSpscQueue<T>::pop(T * pValues, size_t max) {
+	for (;;) {
+		size_t count = tryPop(pValues, max);
+		if (count > 0 || max == 0)
+			return count;
+		const uint32_t key = m_NotEmpty.prepareWait();
+		// Closed is read before the last attempt, elements pushed before close() are not lost
+		const bool closed = m_Closed.load(std::memory_order_acquire);
+		count = tryPop(pValues, max);
+		if (count > 0 || closed) {
+			m_NotEmpty.cancelWait();
+			return count;
+			}
+		m_NotEmpty.wait(key);
+		}
+};
+
+// -------------------------------------------------------
+template <typename T>
+void TSpscQueue<T>::close() {
+	m_Closed.store(true, std::memory_order_release);
+	m_NotEmpty.notifyAll();
+	m_NotFull.notifyAll();
+};
+
+// -------------------------------------------------------
+template <typename T>
+size_t TSpscQueue<T>::size() const {
+	const size_t head = m_Head.load(std::memory_order_acquire);
+	const size_t tail = m_Tail.load(std::memory_order_acquire);
+	return (tail > head) ? tail - head : 0;
+};
+
+// -------------------------------------------------------
+// Template class TMpscQueue<T>
+// -------------------------------------------------------
+template <typename T>
+TMpscQueue<T>::TMpscQueue(size_t capacity)
+	: m_Head(0), m_Tail(0),
+	  m_upSlots(new Slot[roundUpCapacity(capacity)]), m_Mask(roundUpCapacity(capacity) - 1),
+	  m_NotEmpty(), m_NotFull() {
+	for (size_t i = 0; i <= m_Mask; i++) {
+		m_upSlots[i].m_Sequence.store(i, std::memory_order_relaxed);
+		}
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TMpscQueue<T>::tryPush(T value) {
+	return pushOne(value);
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TMpscQueue<T>::pushOne(T & value) {
+	size_t tail = m_Tail.load(std::memory_order_relaxed);
+	Slot * pSlot;
+	for (;;) {
+		if ((tail & CLOSED) != 0)
+			return false; // The closed bit fails the compare-and-swap of a racing producer
+		pSlot = &m_upSlots[tail & m_Mask];
+		const size_t sequence = pSlot->m_Sequence.load(std::memory_order_acquire);
+		if (sequence == tail) {
+			if (m_Tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+				break;
+			}
+		else if (sequence < tail)
+			return false; // Not yet consumed in the previous lap
+		else
+			tail = m_Tail.load(std::memory_order_relaxed);
+		}
+	pSlot->m_Value = std::move(value);
+	pSlot->m_Sequence.store(tail + 1, std::memory_order_release);
+	m_NotEmpty.notifyAll();
+	return true;
+};
+
+// -------------------------------------------------------
+template <typename T>
+size_t TMpscQueue<T>::tryPush(T * pValues, size_t count) {
+	if (count == 1)
+		return pushOne(pValues[0]) ? 1 : 0;
+	size_t tail = m_Tail.load(std::memory_order_relaxed);
+	size_t claimed;
+	for (;;) {
+		if ((tail & CLOSED) != 0)
+			return 0;
+		// The consumer frees the slots in order and before it advances the head
+		const size_t head = m_Head.load(std::memory_order_acquire);
+		if (head > tail) {
+			tail = m_Tail.load(std::memory_order_relaxed); // Outdated meanwhile
+			continue;
+			}
+		// The head is advanced after a batch of slots has been freed, a single push may be ahead
+		const size_t free = (tail - head <= m_Mask) ? m_Mask + 1 - (tail - head) : 0;
+		claimed = (count < free) ? count : free;
+		if (claimed == 0)
+			return 0;
+		if (m_Tail.compare_exchange_weak(tail, tail + claimed, std::memory_order_relaxed))
+			break;
+		}
+	for (size_t i = 0; i < claimed; i++) {
+		Slot & slot = m_upSlots[(tail + i) & m_Mask];
+		slot.m_Value = std::move(pValues[i]);
+		slot.m_Sequence.store(tail + i + 1, std::memory_order_release);
+		}
+	m_NotEmpty.notifyAll();
+	return claimed;
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TMpscQueue<T>::push(T value) {
+	for (;;) {
+		if (tryPush(&value, 1) == 1)
+			return true;
+		if (isClosed())
+			return false;
+		const uint32_t key = m_NotFull.prepareWait();
+		if (isClosed()) {
+			m_NotFull.cancelWait();
+			return false;
+			}
+		if (tryPush(&value, 1) == 1) {
+			m_NotFull.cancelWait();
+			return true;
+			}
+		m_NotFull.wait(key);
+		}
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TMpscQueue<T>::tryPop(T & value) {
+	return tryPop(&value, 1) == 1;
+};
+
+// -------------------------------------------------------
+template <typename T>
+size_t TMpscQueue<T>::tryPop(T * pValues, size_t max) {
+	const size_t head = m_Head.load(std::memory_order_relaxed);
+	size_t count = 0;
+	while (count < max) {
+		Slot & slot = m_upSlots[(head + count) & m_Mask];
+		if (slot.m_Sequence.load(std::memory_order_acquire) != head + count + 1)
+			break; // Empty, or the producer of the slot has not finished yet
+		pValues[count] = std::move(slot.m_Value);
+		slot.m_Sequence.store(head + count + m_Mask + 1, std::memory_order_release);
+		count++;
+		}
+	if (count == 0)
+		return 0;
+	m_Head.store(head + count, std::memory_order_release);
+	m_NotFull.notifyAll();
+	return count;
+};
+
+// -------------------------------------------------------
+template <typename T>
+bool TMpscQueue<T>::pop(T & value) {
+	return pop(&value, 1) == 1;
+};
+
+// -------------------------------------------------------
+template <typename T>
+size_t TMpscQueue<T>::pop(T * pValues, size_t max) {
+	for (;;) {
+		size_t count = tryPop(pValues, max);
+		if (count > 0 || max == 0)
+			return count;
+		const uint32_t key = m_NotEmpty.prepareWait();
+		// The tail of a closed queue is final: drained once the head has reached it
+		const size_t tail = m_Tail.load(std::memory_order_acquire);
+		count = tryPop(pValues, max);
+		if (count > 0 || ((tail & CLOSED) != 0 && (tail & ~CLOSED) == m_Head.load(std::memory_order_relaxed))) {
+			m_NotEmpty.cancelWait();
+			return count;
+			}
+		m_NotEmpty.wait(key);
+		}
+};
+
+// -------------------------------------------------------
+template <typename T>
+void TMpscQueue<T>::close() {
+	m_Tail.fetch_or(CLOSED, std::memory_order_acq_rel);
+	m_NotEmpty.notifyAll();
+	m_NotFull.notifyAll();
+};
+
+// -------------------------------------------------------
+template <typename T>
+size_t TMpscQueue<T>::size() const {
+	const size_t head = m_Head.load(std::memory_order_acquire);
+	const size_t tail = m_Tail.load(std::memory_order_acquire) & ~CLOSED;
+	return (tail > head) ? tail - head : 0;
+};
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_SYNC_QUEUES_H_*/
@@ -0,0 +1,152 @@
+#ifndef _DE_BSWALZ_SYNC_SEQLOCK_H_
+#define _DE_BSWALZ_SYNC_SEQLOCK_H_
+
+/**
+ * Sequence lock for values read far more often than written
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/sync
+ */
+/*
+ * This file is part of common/sync
+ *
+ * common/sync is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* APPLICATION NOTE of TSeqLock
+ * -------------------------------------------------------------------------
+ *	sync::TSeqLock<double> m_Gain(0.0);
+ *
+ *	// Writer, usually already within synchronized(m_Mutex)
+ *	m_Gain.store(gain);
+ *
+ *	// Any number of readers, without any lock
+ *	double gain = m_Gain.load();
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace de { namespace bswalz { namespace sync {
+
+/**
+ * Template class TSeqLock, a value guarded by a sequence number.<br>
+ * A writer makes the sequence odd, copies the value and makes it even again.
+ * A reader copies the value between two reads of an even, unchanged sequence
+ * and retries otherwise. Readers never write shared memory, so they neither
+ * block the writers nor each other, and a read costs two loads and a copy.<br>
+ * Concurrent writers are serialized by the sequence itself.<br>
+ * The value is copied bytewise, hence T has to be trivially copyable. The bytes
+ * are stored in atomic words, a reader racing with a writer reads them by relaxed
+ * atomic loads and discards the copy, so there is no data race.<br>
+ * The class occupies whole cache lines, it does not share one with the members
+ * around it.
+ */
+template <typename T> class alignas(64) TSeqLock {
+public:
+	/**
+	 * @param value the initial value
+	 */
+	explicit TSeqLock(const T & value = T());
+
+	/**
+	 * Stores a value. Called by any thread.
+	 * @param value the new value
+	 */
+	void store(const T & value);
+
+	/**
+	 * @return the value of the last completed store(), never a torn one
+	 */
+	T load() const;
+
+private:
+	TSeqLock(const TSeqLock &);
+	TSeqLock & operator=(const TSeqLock &);
+
+	static const size_t WORDS = (sizeof(T) + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+
+	std::atomic<uint64_t>  m_Sequence;      // Odd while a store() is in progress
+	std::atomic<uintptr_t> m_Words[WORDS];  // The bytes of the value
+}; // End of template <class T> TSeqLock
+
+
+// -------------------------------------------------------
+// Template class TSeqLock<T>
+// -------------------------------------------------------
+template <typename T>
+TSeqLock<T>::TSeqLock(const T & value)
+	: m_Sequence(0) {
+	static_assert(std::is_trivially_copyable<T>::value, "de::bswalz::sync::TSeqLock: T has to be trivially copyable");
+	uintptr_t words[WORDS] = {};
+	std::memcpy(words, &value, sizeof(T));
+	for (size_t i = 0; i < WORDS; i++)
+		m_Words[i].store(words[i], std::memory_order_relaxed);
+};
+
+// -------------------------------------------------------
+template <typename T>
+void TSeqLock<T>::store(const T & value) {
+	uint64_t sequence = m_Sequence.load(std::memory_order_relaxed);
+	while ((sequence & 1) != 0
+	       || !m_Sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+		if ((sequence & 1) != 0) {
+			std::this_thread::yield(); // Another writer, it may wait for this CPU
+			sequence = m_Sequence.load(std::memory_order_relaxed);
+			}
+		}
+	uintptr_t words[WORDS] = {};
+	std::memcpy(words, &value, sizeof(T));
+	std::atomic_thread_fence(std::memory_order_release);
+	for (size_t i = 0; i < WORDS; i++)
+		m_Words[i].store(words[i], std::memory_order_relaxed);
+	m_Sequence.store(sequence + 2, std::memory_order_release);
+};
+
+// -------------------------------------------------------
+template <typename T>
+T TSeqLock<T>::load() const {
+	// T needs not to be default constructible, the copy is made bytewise
+	union Copy {
+		Copy() {}
+		unsigned char m_Bytes[sizeof(T)];
+		T             m_Value;
+	} copy;
+	uintptr_t words[WORDS];
+	for (;;) {
+		const uint64_t sequence = m_Sequence.load(std::memory_order_acquire);
+		if ((sequence & 1) != 0) {
+			std::this_thread::yield(); // The writer may wait for this CPU
+			continue;
+			}
+		for (size_t i = 0; i < WORDS; i++)
+			words[i] = m_Words[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_Sequence.load(std::memory_order_relaxed) == sequence) {
+			std::memcpy(copy.m_Bytes, words, sizeof(T));
+			return copy.m_Value;
+			}
+		}
+};
+
+}}} // End of namespaces
+
+#endif /*_DE_BSWALZ_SYNC_SEQLOCK_H_*/
@@ -26,12 +26,21 @@
  */
 
 #include "Synchronized.h"
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace de { namespace bswalz { namespace sync {
 
+#ifdef DE_BSWALZ_SYNC_PROFILING
+CMutex::CMutex() : std::recursive_mutex(), m_pLockStats(nullptr) {
+	// Intentionally left blank
+}
+#else
 CMutex::CMutex() : std::recursive_mutex() {
 	// Intentionally left blank
 }
+#endif
 
 CMutex::~CMutex() {
 	// Intentionally left blank
@@ -46,13 +55,29 @@ void CMutex::unlock() {
 	std::recursive_mutex::unlock();
 }
 
+void CMutex::setName(const std::string & name) {
+#ifdef DE_BSWALZ_SYNC_PROFILING
+	m_pLockStats = Profiler::getInstance()->getMutexStats(name);
+#else
+	(void)name;
+#endif
+}
+
 CLocker::CLocker(CMutex & mutex)
    : m_Mutex(mutex), m_Locked(true) {
+#ifdef DE_BSWALZ_SYNC_PROFILING
+	m_Probe.lock(m_Mutex);
+#else
 	m_Mutex.lock();
+#endif
 }
    
 CLocker::~CLocker() {
+#ifdef DE_BSWALZ_SYNC_PROFILING
+   m_Probe.unlock(m_Mutex, m_Mutex.getLockStats(), nullptr);
+#else
    m_Mutex.unlock();
+#endif
 }
 
 CLocker::operator bool() const {
@@ -63,4 +88,170 @@ void CLocker::setUnlock() {
    m_Locked = false;
 }
 
+// Shared locks held by the current thread, a thread holds only a few at a time
+static thread_local std::vector<std::pair<const CSharedMutex *, unsigned int>> t_SharedLocks;
+
+static unsigned int * findSharedLock(const CSharedMutex * pMutex) {
+	for (auto & sharedLock : t_SharedLocks) {
+		if (sharedLock.first == pMutex)
+			return &sharedLock.second;
+		}
+	return nullptr;
+}
+
+#ifdef DE_BSWALZ_SYNC_PROFILING
+CSharedMutex::CSharedMutex() : m_Mutex(), m_Owner(std::thread::id()), m_Recursion(0), m_pLockStats(nullptr) {
+	// Intentionally left blank
+}
+#else
+CSharedMutex::CSharedMutex() : m_Mutex(), m_Owner(std::thread::id()), m_Recursion(0) {
+	// Intentionally left blank
+}
+#endif
+
+CSharedMutex::~CSharedMutex() {
+	// Intentionally left blank
+}
+
+void CSharedMutex::lock() {
+	if (isOwner()) {
+		m_Recursion++;
+		return;
+		}
+	if (findSharedLock(this) != nullptr)
+		throw std::logic_error("de::bswalz::sync::CSharedMutex::lock: shared lock cannot be upgraded");
+	m_Mutex.lock();
+	m_Owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+	m_Recursion = 1;
+}
+
+void CSharedMutex::unlock() {
+	if (--m_Recursion == 0) {
+		m_Owner.store(std::thread::id(), std::memory_order_relaxed);
+		m_Mutex.unlock();
+		}
+}
+
+void CSharedMutex::lock_shared() {
+	if (isOwner()) {
+		m_Recursion++; // Within the own exclusive lock
+		return;
+		}
+	unsigned int * pCount = findSharedLock(this);
+	if (pCount != nullptr) {
+		(*pCount)++;   // Nested, a waiting writer must not block this thread
+		return;
+		}
+	m_Mutex.lock_shared();
+	t_SharedLocks.push_back(std::make_pair(this, 1u));
+}
+
+bool CSharedMutex::try_lock() {
+	if (isOwner()) {
+		m_Recursion++;
+		return true;
+		}
+	if (findSharedLock(this) != nullptr || !m_Mutex.try_lock())
+		return false;
+	m_Owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+	m_Recursion = 1;
+	return true;
+}
+
+bool CSharedMutex::try_lock_shared() {
+	if (isOwner()) {
+		m_Recursion++;
+		return true;
+		}
+	unsigned int * pCount = findSharedLock(this);
+	if (pCount != nullptr) {
+		(*pCount)++;
+		return true;
+		}
+	if (!m_Mutex.try_lock_shared())
+		return false;
+	t_SharedLocks.push_back(std::make_pair(this, 1u));
+	return true;
+}
+
+void CSharedMutex::setName(const std::string & name) {
+#ifdef DE_BSWALZ_SYNC_PROFILING
+	m_pLockStats = Profiler::getInstance()->getMutexStats(name);
+#else
+	(void)name;
+#endif
+}
+
+void CSharedMutex::unlock_shared() {
+	if (isOwner()) {
+		unlock();
+		return;
+		}
+	for (auto it = t_SharedLocks.begin(); it != t_SharedLocks.end(); ++it) {
+		if (it->first == this) {
+			if (--it->second == 0) {
+				t_SharedLocks.erase(it);
+				m_Mutex.unlock_shared();
+				}
+			return;
+			}
+		}
+}
+
+#ifdef DE_BSWALZ_SYNC_PROFILING
+CSharedLocker::CSharedLocker(CSharedMutex & mutex, Profiler::CallSite * pSite)
+   : m_Mutex(mutex), m_Locked(true), m_pSite(pSite) {
+	m_Probe.lockShared(m_Mutex);
+}
+
+CSharedLocker::~CSharedLocker() {
+   m_Probe.unlockShared(m_Mutex, m_Mutex.getLockStats(), m_pSite);
+}
+#else
+CSharedLocker::CSharedLocker(CSharedMutex & mutex)
+   : m_Mutex(mutex), m_Locked(true) {
+	m_Mutex.lock_shared();
+}
+
+CSharedLocker::~CSharedLocker() {
+   m_Mutex.unlock_shared();
+}
+#endif
+
+CSharedLocker::operator bool() const {
+   return m_Locked;
+}
+
+void CSharedLocker::setUnlock() {
+   m_Locked = false;
+}
+
+#ifdef DE_BSWALZ_SYNC_PROFILING
+CExclusiveLocker::CExclusiveLocker(CSharedMutex & mutex, Profiler::CallSite * pSite)
+   : m_Mutex(mutex), m_Locked(true), m_pSite(pSite) {
+	m_Probe.lock(m_Mutex);
+}
+
+CExclusiveLocker::~CExclusiveLocker() {
+   m_Probe.unlock(m_Mutex, m_Mutex.getLockStats(), m_pSite);
+}
+#else
+CExclusiveLocker::CExclusiveLocker(CSharedMutex & mutex)
+   : m_Mutex(mutex), m_Locked(true) {
+	m_Mutex.lock();
+}
+
+CExclusiveLocker::~CExclusiveLocker() {
+   m_Mutex.unlock();
+}
+#endif
+
+CExclusiveLocker::operator bool() const {
+   return m_Locked;
+}
+
+void CExclusiveLocker::setUnlock() {
+   m_Locked = false;
+}
+
 }}} // End namespaces
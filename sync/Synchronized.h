@@ -27,7 +27,15 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#ifdef DE_BSWALZ_SYNC_PROFILING
+#include "Profiler.h"
+#endif
 
 namespace de { namespace bswalz { namespace sync {
 
@@ -42,8 +50,21 @@ public:
 	void    lock();
 	/** Unlocks a thread after protection of critical regions */
 	void    unlock();
+	/**
+	 * Sets the name of this mutex for the lock profiler, mutexes of the same name are
+	 * profiled together. Ignored if DE_BSWALZ_SYNC_PROFILING is not defined.
+	 * @param name the name
+	 */
+	void    setName(const std::string & name);
+#ifdef DE_BSWALZ_SYNC_PROFILING
+	/** @return the profiler statistics of the name, nullptr if not named */
+	Profiler::LockStats * getLockStats() const { return m_pLockStats; }
+#endif
 private:
     	CMutex & operator=(const CMutex &);
+#ifdef DE_BSWALZ_SYNC_PROFILING
+	Profiler::LockStats * m_pLockStats;
+#endif
 };
 
 /**
@@ -58,11 +79,148 @@ public:
 private:
     CMutex & m_Mutex;
     bool     m_Locked;
+#ifdef DE_BSWALZ_SYNC_PROFILING
+    LockProbe m_Probe;
+#endif
 };
 
+/**
+  * The locker class of any mutex with lock/unlock semantics, e.g. CMutex or the
+  * mutexes of Mutexes.h. Used by synchronized(M) with the type of M.
+  */
+template <class M> class TLocker {
+public:
+#ifdef DE_BSWALZ_SYNC_PROFILING
+    TLocker( M & mutex, Profiler::CallSite * pSite = nullptr) : m_Mutex(mutex), m_Locked(true), m_pSite(pSite) { m_Probe.lock(m_Mutex); }
+    ~TLocker() { m_Probe.unlock(m_Mutex, getLockStats(m_Mutex), m_pSite); }
+#else
+    TLocker( M & mutex) : m_Mutex(mutex), m_Locked(true) { m_Mutex.lock(); }
+    ~TLocker() { m_Mutex.unlock(); }
+#endif
+    operator bool () const { return m_Locked; }
+    void     setUnlock() { m_Locked = false; }
+private:
+    M &      m_Mutex;
+    bool     m_Locked;
+#ifdef DE_BSWALZ_SYNC_PROFILING
+    Profiler::CallSite * m_pSite;
+    LockProbe            m_Probe;
+#endif
+};
+
+/**
+ * The CSharedMutex class specifies a reader-writer mutex. Many threads may hold
+ * it shared, one thread holds it exclusive.<br>
+ * Like CMutex both locks are recursive: a thread holding the mutex exclusive may
+ * lock it again exclusive or shared, a thread holding it shared may lock it again
+ * shared. A shared lock cannot be upgraded, lock() throws std::logic_error
+ * if the calling thread holds the mutex shared.
+ */
+class CSharedMutex {
+public:
+	CSharedMutex();
+	virtual ~CSharedMutex();
+	/** Locks exclusive, e.g. to modify the protected data */
+	void    lock();
+	/** Unlocks after lock() */
+	void    unlock();
+	/** Locks shared, e.g. to read the protected data */
+	void    lock_shared();
+	/** Unlocks after lock_shared() */
+	void    unlock_shared();
+	/** @return true if locked exclusive without waiting */
+	bool    try_lock();
+	/** @return true if locked shared without waiting */
+	bool    try_lock_shared();
+	/**
+	 * Sets the name of this mutex for the lock profiler
+	 * @param name the name
+	 * @see CMutex::setName()
+	 */
+	void    setName(const std::string & name);
+#ifdef DE_BSWALZ_SYNC_PROFILING
+	/** @return the profiler statistics of the name, nullptr if not named */
+	Profiler::LockStats * getLockStats() const { return m_pLockStats; }
+#endif
+private:
+	CSharedMutex(const CSharedMutex &);
+	CSharedMutex & operator=(const CSharedMutex &);
+
+	bool    isOwner() const { return m_Owner.load(std::memory_order_relaxed) == std::this_thread::get_id(); }
+
+	std::shared_mutex            m_Mutex;
+	std::atomic<std::thread::id> m_Owner;       // The thread holding the mutex exclusive
+	unsigned int                 m_Recursion;   // Locks of the owner, shared ones included
+#ifdef DE_BSWALZ_SYNC_PROFILING
+	Profiler::LockStats *        m_pLockStats;
+#endif
+};
+
+/**
+  * The locker class of a shared lock
+  */
+class CSharedLocker {
+public:
+#ifdef DE_BSWALZ_SYNC_PROFILING
+    CSharedLocker( CSharedMutex & mutex, Profiler::CallSite * pSite = nullptr);
+#else
+    CSharedLocker( CSharedMutex & mutex);
+#endif
+    virtual  ~CSharedLocker();
+    operator bool () const;
+    void     setUnlock();
+private:
+    CSharedMutex & m_Mutex;
+    bool           m_Locked;
+#ifdef DE_BSWALZ_SYNC_PROFILING
+    Profiler::CallSite * m_pSite;
+    LockProbe            m_Probe;
+#endif
+};
+
+/**
+  * The locker class of an exclusive lock
+  */
+class CExclusiveLocker {
+public:
+#ifdef DE_BSWALZ_SYNC_PROFILING
+    CExclusiveLocker( CSharedMutex & mutex, Profiler::CallSite * pSite = nullptr);
+#else
+    CExclusiveLocker( CSharedMutex & mutex);
+#endif
+    virtual  ~CExclusiveLocker();
+    operator bool () const;
+    void     setUnlock();
+private:
+    CSharedMutex & m_Mutex;
+    bool           m_Locked;
+#ifdef DE_BSWALZ_SYNC_PROFILING
+    Profiler::CallSite * m_pSite;
+    LockProbe            m_Probe;
+#endif
+};
+
+#ifdef DE_BSWALZ_SYNC_PROFILING
+/** @return the profiler statistics of a named CMutex */
+inline Profiler::LockStats * getLockStats(const CMutex & mutex) { return mutex.getLockStats(); }
+/** @return the profiler statistics of a named CSharedMutex */
+inline Profiler::LockStats * getLockStats(const CSharedMutex & mutex) { return mutex.getLockStats(); }
+#endif
+
 }}} // End namespaces
 
-#define synchronized(M)  for(sync::CLocker M##_Lock = M; M##_Lock; M##_Lock.setUnlock()) 
+#ifdef DE_BSWALZ_SYNC_PROFILING
+// Every expansion owns a call site, registered at its first execution
+#define DE_BSWALZ_SYNC_CALL_SITE(M)  ([]() { static sync::Profiler::CallSite site(__FILE__, __LINE__, #M); return &site; }())
+#define synchronized(M)  for(sync::TLocker<std::remove_reference_t<decltype(M)>> M##_Lock(M, DE_BSWALZ_SYNC_CALL_SITE(M)); M##_Lock; M##_Lock.setUnlock())
+#define synchronized_shared(M)     for(sync::CSharedLocker M##_SharedLock(M, DE_BSWALZ_SYNC_CALL_SITE(M)); M##_SharedLock; M##_SharedLock.setUnlock())
+#define synchronized_exclusive(M)  for(sync::CExclusiveLocker M##_ExclusiveLock(M, DE_BSWALZ_SYNC_CALL_SITE(M)); M##_ExclusiveLock; M##_ExclusiveLock.setUnlock())
+#else
+// The locker is selected by the type of M, hence every mutex of Mutexes.h works with synchronized(M)
+#define synchronized(M)  for(sync::TLocker<std::remove_reference_t<decltype(M)>> M##_Lock = M; M##_Lock; M##_Lock.setUnlock())
+#define synchronized_shared(M)     for(sync::CSharedLocker M##_SharedLock = M; M##_SharedLock; M##_SharedLock.setUnlock())
+#define synchronized_exclusive(M)  for(sync::CExclusiveLocker M##_ExclusiveLock = M; M##_ExclusiveLock; M##_ExclusiveLock.setUnlock())
+#endif
 
 
 #endif /*_DE_BSWALZ_MODEL_NUMLIMITS_H_*/
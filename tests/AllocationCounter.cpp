@@ -0,0 +1,79 @@
+/**
+ * Allocation counter of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long> s_Allocations(0);
+
+// -------------------------------------------------------
+long getAllocations() {
+	return s_Allocations.load();
+}
+
+// -------------------------------------------------------
+// Counts and allocates, nullptr if out of memory
+static void * allocate(size_t size, size_t alignment) {
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	if (size == 0)
+		size = 1;
+	if (alignment <= alignof(std::max_align_t))
+		return std::malloc(size);
+	// aligned_alloc() requires a multiple of the alignment
+	return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+// -------------------------------------------------------
+void * operator new(size_t size) {
+	void * p = allocate(size, 0);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+void * operator new(size_t size, const std::nothrow_t &) noexcept {
+	return allocate(size, 0);
+}
+void * operator new(size_t size, std::align_val_t alignment) {
+	void * p = allocate(size, size_t(alignment));
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+void * operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+	return allocate(size, size_t(alignment));
+}
+
+// -------------------------------------------------------
+// The array forms call these by default
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, size_t) noexcept { std::free(p); }
+void operator delete(void * p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void * p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void * p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void * p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
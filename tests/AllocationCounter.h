@@ -0,0 +1,42 @@
+#ifndef _DE_BSWALZ_TESTS_ALLOCATIONCOUNTER_H_
+#define _DE_BSWALZ_TESTS_ALLOCATIONCOUNTER_H_
+
+/**
+ * Allocation counter of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The replacements of the global operator new and delete count every heap
+ * allocation of the test program. They are compiled in a translation unit
+ * of their own: inlined into the test, the compiler pairs the inlined free()
+ * with a call of operator new (-Wmismatched-new-delete).
+ */
+
+/**
+ * @return the number of heap allocations since the start of the program
+ */
+long getAllocations();
+
+#endif /*_DE_BSWALZ_TESTS_ALLOCATIONCOUNTER_H_*/
@@ -0,0 +1,60 @@
+#ifndef _DE_BSWALZ_TESTS_CHECK_H_
+#define _DE_BSWALZ_TESTS_CHECK_H_
+
+/**
+ * Minimal checks of the test programs of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../mvc/View.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Number of failed checks of the test program
+inline int s_Failures = 0;
+
+// Counts and reports a failed condition, the test continues
+#define CHECK(C) \
+	do { if (!(C)) { s_Failures++; std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #C); } } while (0)
+
+// Reports the result of the test program, used as return value of main()
+#define CHECK_RESULT(NAME) \
+	(std::printf("%s: %s\n", NAME, s_Failures ? "FAILED" : "OK"), s_Failures ? 1 : 0)
+
+// Counts its updates, a delay simulates a slow view
+class CountingView : public de::bswalz::mvc::View {
+public:
+	explicit CountingView(std::chrono::microseconds delay = std::chrono::microseconds(0)) : m_Delay(delay), m_Updates(0) {}
+	virtual void update(const de::bswalz::mvc::Model *, void *) override {
+		if (m_Delay.count() > 0)
+			std::this_thread::sleep_for(m_Delay);
+		m_Updates.fetch_add(1);
+	}
+	const std::chrono::microseconds m_Delay;
+	std::atomic<long>               m_Updates;
+};
+
+#endif /*_DE_BSWALZ_TESTS_CHECK_H_*/
@@ -0,0 +1,200 @@
+/**
+ * Allocation test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Counts the heap allocations of the notification paths. Once warmed up, a
+ * notification must not allocate: synchronous and asynchronous delivery,
+ * AssignRule chains without a fan-in, filtered subscriptions, the parallel
+ * fan-out and views updated by an executor.
+ */
+
+#include "AllocationCounter.h"
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../mvc/Executor.h"
+#include "../mvc/View.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+class IncrementRule : public mvc::TAssignRule<int> {
+public:
+	explicit IncrementRule(CIntParameter * pTarget) : m_pTarget(pTarget) { addTarget(pTarget); }
+	virtual void apply(mvc::TModel<int> * pSource) override { m_pTarget->assignValue(pSource->getValue() + 1, this); }
+	virtual void revert() override { m_pTarget->revertAssignment(); }
+private:
+	CIntParameter * m_pTarget;
+};
+
+static long sumUpdates(const std::vector<CountingView> & views) {
+	long sum = 0;
+	for (const CountingView & view : views)
+		sum += view.m_Updates.load();
+	return sum;
+}
+
+// Assigns n values and waits for the asynchronous delivery, returns the allocations
+static long assignAndWait(CIntParameter & model, const std::vector<CountingView> & views, int n) {
+	const long expected = sumUpdates(views) + long(n) * long(views.size());
+	const long allocations = getAllocations();
+	for (int i = 0; i < n; i++) {
+		model.assignValue(model.getValue() + 1);
+		if (i % 64 == 0) {
+			// Keeps the queue within the capacity reached by the first round
+			while (sumUpdates(views) < expected - long(n - i - 1) * long(views.size()))
+				std::this_thread::yield();
+			}
+		}
+	while (sumUpdates(views) < expected)
+		std::this_thread::yield();
+	return getAllocations() - allocations;
+}
+
+// -------------------------------------------------------
+static void testSynchronous() {
+	CIntParameter model("sync", 0, 0, 100000000);
+	std::vector<CountingView> views(3);
+	for (CountingView & view : views)
+		view.registerAt(&model);
+	for (int i = 1; i <= 1000; i++)
+		model.assignValue(i);
+	const long allocations = getAllocations();
+	for (int i = 1001; i <= 100000; i++)
+		model.assignValue(i);
+	CHECK(getAllocations() == allocations);
+	CHECK(sumUpdates(views) == 3 * 100000L);
+	for (CountingView & view : views)
+		view.unregisterAt(&model);
+}
+
+// -------------------------------------------------------
+static void testAsynchronous() {
+	CIntParameter model("async", 0, 0, 100000000);
+	model.setSyncMode(false);
+	std::vector<CountingView> views(3);
+	for (CountingView & view : views)
+		view.registerAt(&model);
+	assignAndWait(model, views, 100000);            // Cold: the queues grow
+	CHECK(assignAndWait(model, views, 100000) == 0);
+	for (CountingView & view : views)
+		view.unregisterAt(&model);
+}
+
+// -------------------------------------------------------
+static void testAssignRuleChain() {
+	CIntParameter a("a", 0, -1000000, 1000000), b("b", 0, -1000000, 1000000), c("c", 0, -1000000, 1000000);
+	IncrementRule ab(&b), bc(&c);
+	a.addAssignRule(&ab);
+	b.addAssignRule(&bc);
+	std::vector<CountingView> views(3);
+	views[0].registerAt(&a);
+	views[1].registerAt(&b);
+	views[2].registerAt(&c);
+	a.assignValue(1);
+	const long allocations = getAllocations();
+	for (int i = 2; i < 1000; i++)
+		a.assignValue(i);
+	CHECK(getAllocations() == allocations);
+	CHECK(c.getValue() == 1001);
+	views[0].unregisterAt(&a);
+	views[1].unregisterAt(&b);
+	views[2].unregisterAt(&c);
+}
+
+// -------------------------------------------------------
+static void testFilteredSubscriptions() {
+	CIntParameter model("filtered", 0, 0, 1000000);
+	long calls = 0;
+	for (int i = 0; i < 40; i++) {
+		// The first 16 subscriptions accept every value, the others a change of 10
+		model.subscribeFiltered([&calls](const int &, const int &) { calls++; },
+			[i](const int & value, const int & last) { return i < 16 || value - last >= 10; });
+		}
+	model.assignValue(1);
+	const long allocations = getAllocations();
+	for (int i = 2; i <= 9; i++)
+		model.assignValue(i);
+	CHECK(getAllocations() == allocations);
+	CHECK(calls == 9 * 16);
+}
+
+// -------------------------------------------------------
+static void testParallelFanOut() {
+	CIntParameter model("parallel", 0, 0, 100000000);
+	model.setParallelFanOut(2);
+	std::vector<CountingView> views(64);
+	for (CountingView & view : views)
+		view.registerAt(&model);
+	for (int i = 1; i <= 100; i++)
+		model.assignValue(i);
+	const long allocations = getAllocations();
+	for (int i = 101; i <= 10000; i++)
+		model.assignValue(i);
+	CHECK(getAllocations() == allocations);
+	CHECK(sumUpdates(views) == 64 * 10000L);
+	for (CountingView & view : views)
+		view.unregisterAt(&model);
+}
+
+// -------------------------------------------------------
+static void testExecutor() {
+	mvc::ExecutorQueue queue;
+	std::atomic<bool> running(true);
+	std::thread owner([&]() {
+		while (running) {
+			queue.wait(std::chrono::milliseconds(1));
+			queue.runPending();
+			}
+		queue.runPending();
+		});
+	CIntParameter model("executor", 0, 0, 100000000);
+	std::vector<CountingView> views(3);
+	for (CountingView & view : views) {
+		view.setExecutor(&queue);
+		view.registerAt(&model);
+		}
+	assignAndWait(model, views, 10000);             // Cold: the task vectors grow
+	CHECK(assignAndWait(model, views, 10000) == 0);
+	for (CountingView & view : views)
+		view.unregisterAt(&model);
+	running = false;
+	owner.join();
+}
+
+// -------------------------------------------------------
+int main() {
+	testSynchronous();
+	testAsynchronous();
+	testAssignRuleChain();
+	testFilteredSubscriptions();
+	testParallelFanOut();
+	testExecutor();
+	return CHECK_RESULT("TestAllocations");
+}
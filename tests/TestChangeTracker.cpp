@@ -0,0 +1,144 @@
+/**
+ * Change tracker test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A ChangeTracker reports the models whose value has actually changed: neither
+ * rejected, reverted nor unchanged assignments stamp an epoch.
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../mvc/ChangeTracker.h"
+#include "../mvc/Transaction.h"
+#include <memory>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+// Accepts values up to a limit
+class LimitVoter : public mvc::TVoter<int> {
+public:
+	LimitVoter(CIntParameter * pModel, int limit) : m_pModel(pModel), m_Limit(limit) { dependsOn(pModel); }
+	virtual bool vote() override { return m_pModel->getValue() <= m_Limit; }
+	CIntParameter * m_pModel;
+	const int       m_Limit;
+};
+
+// Polls the tracker, returns the number of changed models
+static size_t poll(mvc::ChangeTracker & tracker) {
+	std::vector<const mvc::Model *> changed;
+	return tracker.poll(changed);
+}
+
+// -------------------------------------------------------
+static void testAssignments() {
+	CIntParameter gain("gain", 0, 0, 100);
+	mvc::TModel<int> plain("plain", 0);
+	mvc::ChangeTracker tracker;
+	tracker.track(&gain);
+	tracker.track(&plain);
+	CHECK(poll(tracker) == 2);      // Initially reported
+	CHECK(poll(tracker) == 0);
+
+	gain.assignValue(0);
+	plain.assignValue(0);
+	CHECK(poll(tracker) == 0);      // Unchanged
+	gain.assignValue(-5);
+	CHECK(poll(tracker) == 0);      // Limited to the unchanged minimum
+	gain.assignValue(7);
+	plain.assignValue(7);
+	CHECK(poll(tracker) == 2);
+	CHECK(gain.getEpoch() != plain.getEpoch());
+
+	gain.setVoter(std::make_shared<LimitVoter>(&gain, 50));
+	CHECK(!gain.assignValue(60));
+	CHECK(gain.getValue() == 7);
+	CHECK(poll(tracker) == 0);      // Rejected by the voter
+	CHECK(gain.assignValue(40));
+	CHECK(poll(tracker) == 1);
+}
+
+// -------------------------------------------------------
+static void testTransactions() {
+	CIntParameter gain("gain", 0, 0, 100), balance("balance", 0, -100, 100);
+	mvc::ChangeTracker tracker;
+	tracker.track(&gain);
+	tracker.track(&balance);
+	poll(tracker);
+	{
+		mvc::Transaction transaction;
+		gain.assignValue(10);
+		balance.assignValue(-10);
+		transaction.rollback();
+	}
+	CHECK(gain.getValue() == 0);
+	CHECK(poll(tracker) == 0);      // Rolled back
+
+	{
+		mvc::Transaction transaction;
+		gain.assignValue(10);
+		balance.assignValue(0);     // Unchanged
+		CHECK(poll(tracker) == 0);  // Not yet committed
+		CHECK(transaction.commit());
+	}
+	std::vector<const mvc::Model *> changed;
+	CHECK(tracker.poll(changed) == 1);
+	CHECK(changed.size() == 1 && changed[0] == &gain);
+}
+
+// -------------------------------------------------------
+static void testParameters() {
+	CIntParameter gain("gain", 5, 0, 100);
+	CBoolParameter enabled("enabled", true);
+	CIntArrayParameter levels("levels", var_array<int>(4, 0));
+	mvc::ChangeTracker tracker;
+	tracker.track(&gain);
+	tracker.track(&enabled);
+	tracker.track(&levels);
+	poll(tracker);
+
+	gain.setDefaultValue();
+	enabled.setRelevance(true);
+	levels.assignElementValue(0, 2);
+	levels.assignValue(var_array<int>(4, 0));
+	CHECK(poll(tracker) == 0);      // Unchanged
+
+	gain.assignValue(6);
+	gain.setDefaultValue();
+	enabled.setRelevance(false);
+	levels.assignElementValue(3, 2);
+	CHECK(poll(tracker) == 3);
+}
+
+// -------------------------------------------------------
+int main() {
+	testAssignments();
+	testTransactions();
+	testParameters();
+	return CHECK_RESULT("TestChangeTracker");
+}
@@ -0,0 +1,107 @@
+/**
+ * Coroutine test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Coroutines awaiting TModel<T>::changed(), resumed by an executor: coalesced
+ * values, and a coroutine destroyed while its resumption is queued. Built with
+ * -std=c++20.
+ */
+
+#include "Check.h"
+#include "../mvc/Executor.h"
+#include "../mvc/Model.h"
+#include <coroutine>
+#include <exception>
+#include <vector>
+
+using namespace de::bswalz;
+
+// A coroutine which starts at once and is destroyed by its owner
+struct Task {
+	struct promise_type {
+		Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_never  initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+	explicit Task(std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+	Task(Task && r) : m_Handle(r.m_Handle) { r.m_Handle = nullptr; }
+	~Task() { if (m_Handle) m_Handle.destroy(); }
+	std::coroutine_handle<promise_type> m_Handle;
+};
+
+// Awaits count changes of the model, records the values
+static Task watch(mvc::TModel<int> * pModel, mvc::IExecutor * pExecutor, std::vector<int> * pValues, int count) {
+	auto changes = pModel->changed(pExecutor);
+	for (int i = 0; i < count; i++)
+		pValues->push_back(co_await changes);
+}
+
+// -------------------------------------------------------
+static void testExecutor() {
+	mvc::TModel<int> model("model", 0);
+	mvc::ExecutorQueue queue;
+	std::vector<int> values;
+	Task task = watch(&model, &queue, &values, 2);
+	model.assignValue(1);
+	model.assignValue(2);                   // Coalesced with 1
+	CHECK(values.empty());                  // Resumed by the executor only
+	queue.runPending();
+	CHECK(values.size() == 1 && values[0] == 2);
+	model.assignValue(3);
+	queue.runPending();
+	CHECK(values.size() == 2 && values[1] == 3);
+	CHECK(task.m_Handle.done());
+}
+
+// -------------------------------------------------------
+static void testCancel() {
+	mvc::TModel<int> model("model", 0);
+	mvc::ExecutorQueue queue;
+	std::vector<int> values;
+	{
+		Task task = watch(&model, &queue, &values, 1);
+		model.assignValue(1);               // Queues the resumption
+	}                                       // Destroys the frame and the stream
+	queue.runPending();                     // Must not resume the destroyed coroutine
+	CHECK(values.empty());
+
+	// Cancelled before any notification
+	{
+		Task task = watch(&model, &queue, &values, 1);
+	}
+	model.assignValue(2);
+	queue.runPending();
+	CHECK(values.empty());
+}
+
+// -------------------------------------------------------
+int main() {
+	testExecutor();
+	testCancel();
+	return CHECK_RESULT("TestChanges");
+}
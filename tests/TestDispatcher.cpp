@@ -0,0 +1,86 @@
+/**
+ * Dispatcher test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The Dispatcher executes the tasks of a key in the order they have been
+ * posted, and its worker count cannot be changed once it has been started.
+ */
+
+#include "Check.h"
+#include "../mvc/Dispatcher.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+
+// -------------------------------------------------------
+static void testOrderPerKey() {
+	const int keys = 8, tasks = 10000;
+	std::vector<std::vector<int>> sequences(keys);
+	std::atomic<long> done(0);
+	mvc::Dispatcher * pDispatcher = mvc::Dispatcher::getInstance();
+	CHECK(mvc::Dispatcher::getWorkerCount() == 4);
+	for (int i = 0; i < tasks; i++) {
+		for (int k = 0; k < keys; k++) {
+			// A key is executed by one worker only, its sequence needs no lock
+			std::vector<int> * pSequence = &sequences[k];
+			pDispatcher->post(pSequence, [pSequence, i, &done]() { pSequence->push_back(i); done++; });
+			}
+		}
+	while (done.load() < long(keys) * tasks)
+		std::this_thread::yield();
+	for (const std::vector<int> & sequence : sequences) {
+		bool ordered = sequence.size() == size_t(tasks);
+		for (size_t i = 0; ordered && i < sequence.size(); i++)
+			ordered = sequence[i] == int(i);
+		CHECK(ordered);
+		}
+}
+
+// -------------------------------------------------------
+static void testWorkerCountAfterStart() {
+	bool thrown = false;
+	try {
+		mvc::Dispatcher::setWorkerCount(2);
+		}
+	catch (const std::logic_error &) {
+		thrown = true;
+		}
+	CHECK(thrown);
+	CHECK(mvc::Dispatcher::getWorkerCount() == 4);
+}
+
+// -------------------------------------------------------
+int main() {
+	mvc::Dispatcher::setWorkerCount(4);
+	testOrderPerKey();
+	testWorkerCountAfterStart();
+	mvc::Dispatcher::shutdown();
+	CHECK(mvc::Dispatcher::getInstance() == nullptr);
+	return CHECK_RESULT("TestDispatcher");
+}
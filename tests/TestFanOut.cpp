@@ -0,0 +1,107 @@
+/**
+ * Fan-out test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The FanOutPool processes every item of a range exactly once and a parallel
+ * fan-out updates every view exactly once per notification. The worker count
+ * cannot be changed once the pool has been started.
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../mvc/FanOutPool.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+static void testRange() {
+	std::vector<std::atomic<int>> items(10000);
+	for (std::atomic<int> & item : items)
+		item = 0;
+	std::atomic<int> * pItems = items.data();
+	for (size_t chunkSize : { size_t(0), size_t(1), size_t(7), size_t(20000) }) {
+		mvc::FanOutPool::getInstance()->run(items.size(), [pItems](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++)
+				pItems[i]++;
+			}, chunkSize);
+		}
+	auto spCompletion = mvc::FanOutPool::getInstance()->submit(items.size(), [pItems](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			pItems[i]++;
+		});
+	spCompletion->wait();
+	bool once = true;
+	for (std::atomic<int> & item : items)
+		once &= item.load() == 5;
+	CHECK(once);
+	mvc::FanOutPool::getInstance()->run(0, [](size_t, size_t) {});
+}
+
+// -------------------------------------------------------
+static void testViews() {
+	CIntParameter model("units", 0, 0, 1000000);
+	model.setParallelFanOut(2);
+	std::vector<std::unique_ptr<CountingView>> views;
+	for (int i = 0; i < 1000; i++) {
+		views.emplace_back(new CountingView());
+		views.back()->registerAt(&model);
+		}
+	for (int i = 1; i <= 100; i++)
+		model.assignValue(i);
+	bool once = true;
+	for (const auto & upView : views)
+		once &= upView->m_Updates.load() == 100;
+	CHECK(once);
+	for (const auto & upView : views)
+		upView->unregisterAt(&model);
+}
+
+// -------------------------------------------------------
+static void testWorkerCountAfterStart() {
+	bool thrown = false;
+	try {
+		mvc::FanOutPool::setWorkerCount(2);
+		}
+	catch (const std::logic_error &) {
+		thrown = true;
+		}
+	CHECK(thrown);
+	CHECK(mvc::FanOutPool::getWorkerCount() == 4);
+}
+
+// -------------------------------------------------------
+int main() {
+	mvc::FanOutPool::setWorkerCount(4);
+	testRange();
+	testViews();
+	testWorkerCountAfterStart();
+	return CHECK_RESULT("TestFanOut");
+}
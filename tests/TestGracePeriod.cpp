@@ -0,0 +1,112 @@
+/**
+ * Grace period test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Snapshots of a TRcuPointer are deleted after the readers which may have
+ * loaded them are done, and snapshots retired by a reader are deferred.
+ */
+
+#include "Check.h"
+#include "../mvc/GracePeriod.h"
+#include <atomic>
+#include <thread>
+
+using namespace de::bswalz;
+
+// -------------------------------------------------------
+// Invalidated by its destructor
+struct Snapshot {
+	static const int VALID = 0x5A5A5A5A;
+	explicit Snapshot(int value) : m_Valid(VALID), m_Value(value) {}
+	~Snapshot() { m_Valid = 0; s_Deleted++; }
+	volatile int m_Valid;
+	int          m_Value;
+	static std::atomic<long> s_Deleted;
+};
+std::atomic<long> Snapshot::s_Deleted(0);
+
+// -------------------------------------------------------
+static void testReadersAndWriter() {
+	mvc::GracePeriod grace;
+	mvc::TRcuPointer<Snapshot> pointer(grace);
+	pointer.exchange(new Snapshot(0));
+	std::atomic<bool> running(true);
+	std::atomic<long> invalid(0), reads(0);
+	std::thread readers[2];
+	for (std::thread & reader : readers) {
+		reader = std::thread([&]() {
+			while (running) {
+				mvc::GracePeriod::Reader scope(grace);
+				const Snapshot * pSnapshot = pointer.load();
+				for (int i = 0; i < 100; i++) {
+					if (pSnapshot->m_Valid != Snapshot::VALID)
+						invalid++;
+					}
+				reads++;
+				}
+			});
+		}
+	const long deleted = Snapshot::s_Deleted.load();
+	for (int i = 1; i <= 2000; i++) {
+		CHECK(pointer.retire(pointer.exchange(new Snapshot(i))));
+		if (i % 100 == 0)
+			std::this_thread::yield();
+		}
+	running = false;
+	for (std::thread & reader : readers)
+		reader.join();
+	CHECK(invalid.load() == 0);
+	CHECK(reads.load() > 0);
+	CHECK(Snapshot::s_Deleted.load() - deleted == 2000);
+	CHECK(pointer.load()->m_Value == 2000);
+}
+
+// -------------------------------------------------------
+static void testRetiredByReader() {
+	mvc::GracePeriod grace;
+	mvc::TRcuPointer<Snapshot> pointer(grace);
+	pointer.exchange(new Snapshot(1));
+	const long deleted = Snapshot::s_Deleted.load();
+	{
+		mvc::GracePeriod::Reader scope(grace);
+		CHECK(mvc::GracePeriod::isReader());
+		const Snapshot * pSnapshot = pointer.load();
+		// A reader must not wait for itself, the old snapshot is kept
+		CHECK(!pointer.retire(pointer.exchange(new Snapshot(2))));
+		CHECK(pSnapshot->m_Valid == Snapshot::VALID);
+		CHECK(Snapshot::s_Deleted.load() == deleted);
+	}
+	CHECK(!mvc::GracePeriod::isReader());
+	CHECK(pointer.retire(nullptr));
+	CHECK(Snapshot::s_Deleted.load() == deleted + 1);
+}
+
+// -------------------------------------------------------
+int main() {
+	testReadersAndWriter();
+	testRetiredByReader();
+	return CHECK_RESULT("TestGracePeriod");
+}
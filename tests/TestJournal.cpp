@@ -0,0 +1,116 @@
+/**
+ * Journal test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The journal of a model: replay after an epoch, gaps after the ring has been
+ * overwritten, and readers replaying while the model records.
+ */
+
+#include "Check.h"
+#include "../mvc/Model.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+
+typedef mvc::TJournal<int>::Entry Entry;
+
+// -------------------------------------------------------
+static void testReplay() {
+	mvc::TModel<int> model("journal", 0);
+	CHECK(model.getJournal() == nullptr);
+	model.enableJournal(6);                // Rounded up to 8
+	CHECK(model.getJournal()->getCapacity() == 8);
+	bool thrown = false;
+	try {
+		model.enableJournal(8);
+		}
+	catch (const std::logic_error &) {
+		thrown = true;
+		}
+	CHECK(thrown);
+
+	for (int i = 1; i <= 5; i++)
+		model.assignValue(i);
+	std::vector<Entry> entries;
+	CHECK(model.getJournal()->replay(0, entries));
+	CHECK(entries.size() == 5);
+	for (size_t i = 0; i < entries.size(); i++)
+		CHECK(entries[i].m_Value == int(i) + 1);
+	CHECK(entries.back().m_Epoch == model.getEpoch());
+
+	// Only the entries after the known epoch
+	const uint64_t known = entries[2].m_Epoch;
+	CHECK(model.getJournal()->replay(known, entries));
+	CHECK(entries.size() == 2 && entries[0].m_Value == 4 && entries[1].m_Value == 5);
+	CHECK(model.getJournal()->replay(model.getEpoch(), entries));
+	CHECK(entries.empty());
+
+	// The ring has overwritten the entries after the known epoch
+	for (int i = 6; i <= 20; i++)
+		model.assignValue(i);
+	CHECK(model.getJournal()->getRecordCount() == 20);
+	CHECK(!model.getJournal()->replay(known, entries));
+	CHECK(entries.size() == 8 && entries[0].m_Value == 13 && entries[7].m_Value == 20);
+}
+
+// -------------------------------------------------------
+// Readers replay without a lock while the model records
+static void testConcurrentReplay() {
+	mvc::TModel<int> model("journal", 0);
+	model.enableJournal(16);
+	std::atomic<bool> running(true);
+	std::atomic<long> wrong(0);
+	std::vector<std::thread> readers;
+	for (int t = 0; t < 2; t++) {
+		readers.emplace_back([&]() {
+			std::vector<Entry> entries;
+			while (running) {
+				model.getJournal()->replay(0, entries);
+				for (size_t i = 1; i < entries.size(); i++) {
+					// Values increase with the epochs, a torn entry breaks the order
+					if (entries[i].m_Epoch <= entries[i - 1].m_Epoch || entries[i].m_Value <= entries[i - 1].m_Value)
+						wrong++;
+					}
+				}
+			});
+		}
+	for (int i = 1; i <= 100000; i++)
+		model.assignValue(i);
+	running = false;
+	for (std::thread & reader : readers)
+		reader.join();
+	CHECK(wrong == 0);
+}
+
+// -------------------------------------------------------
+int main() {
+	testReplay();
+	testConcurrentReplay();
+	return CHECK_RESULT("TestJournal");
+}
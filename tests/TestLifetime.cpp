@@ -0,0 +1,249 @@
+/**
+ * Lifetime test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Models and views deleted while notifications are queued by the Dispatcher or
+ * by an executor, and the grace period of unregisterAt() while the views are
+ * updated by another thread. Run it under AddressSanitizer, e.g.
+ * make CXXFLAGS="-std=c++17 -O1 -g -fsanitize=address" check
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../mvc/Executor.h"
+#include "../mvc/View.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+// Reads the model, hence fails under AddressSanitizer if the model has been deleted
+class ReadingView : public mvc::View {
+public:
+	ReadingView() : m_Updates(0) {}
+	virtual void update(const mvc::Model * pModel, void *) override {
+		volatile int value = static_cast<const mvc::TModel<int> *>(pModel)->load();
+		(void)value;
+		std::this_thread::sleep_for(std::chrono::microseconds(20));
+		m_Updates++;
+	}
+	std::atomic<long> m_Updates;
+};
+
+// Counts the updates received after its unregistration
+class UnregisteredView : public mvc::View {
+public:
+	UnregisteredView() : m_Unregistered(false), m_Violations(0) {}
+	virtual void update(const mvc::Model *, void *) override {
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+		if (m_Unregistered)
+			m_Violations++;
+	}
+	std::atomic<bool> m_Unregistered;
+	std::atomic<int>  m_Violations;
+};
+
+// Re-registers itself during its update
+class ReregisteringView : public mvc::View {
+public:
+	explicit ReregisteringView(mvc::Model * pModel) : m_pModel(pModel) { registerAt(pModel); }
+	virtual void update(const mvc::Model *, void *) override {
+		unregisterAt(m_pModel);
+		registerAt(m_pModel);
+	}
+	mvc::Model * m_pModel;
+};
+
+// Typed view which reports updates after its destruction
+class DestroyedTView : public mvc::TView<int> {
+public:
+	DestroyedTView(CIntParameter * pModel, std::atomic<int> * pViolations)
+		: m_pModel(pModel), m_pViolations(pViolations), m_Destroyed(false) { registerAt(pModel); }
+	virtual ~DestroyedTView() {
+		unregisterAt(m_pModel);
+		m_Destroyed = true;
+	}
+	virtual void update(const mvc::TModel<int> *, const int &, const int &) override {
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+		if (m_Destroyed)
+			(*m_pViolations)++;
+	}
+	CIntParameter *    m_pModel;
+	std::atomic<int> * m_pViolations;
+	std::atomic<bool>  m_Destroyed;
+};
+
+// -------------------------------------------------------
+static void testDeletedModels() {
+	ReadingView view;
+	for (int round = 0; round < 100; round++) {
+		std::vector<CIntParameter *> models;
+		for (int k = 0; k < 16; k++) {
+			CIntParameter * pModel = new CIntParameter("m", 0, 0, 1000);
+			pModel->setSyncMode(false);
+			pModel->setCoalescingMode(k % 2 == 0);
+			view.registerAt(pModel);
+			models.push_back(pModel);
+			}
+		for (int i = 1; i <= 64; i++)
+			models[i % 16]->assignValue(i);
+		for (CIntParameter * pModel : models) {
+			view.unregisterAt(pModel);
+			delete pModel;
+			}
+		}
+	CHECK(view.m_Updates <= 100 * 64);
+}
+
+// -------------------------------------------------------
+static void testExecutorViews() {
+	mvc::ExecutorQueue queue;
+	{
+		// Queued updates of an unregistered model are discarded
+		CountingView * pView = new CountingView();
+		pView->setExecutor(&queue);
+		CIntParameter * pModel = new CIntParameter("m", 0, 0, 1000);
+		CIntParameter other("o", 0, 0, 1000);
+		pView->registerAt(pModel);
+		pView->registerAt(&other);
+		for (int i = 1; i <= 5; i++)
+			pModel->assignValue(i);
+		other.assignValue(1);
+		pView->unregisterAt(pModel);
+		delete pModel;
+		queue.runPending();
+		CHECK(pView->m_Updates == 1);
+		pView->unregisterAt(&other);
+		other.assignValue(2);
+		delete pView;
+		other.assignValue(3);
+		CHECK(queue.runPending() == 0);
+	}
+	{
+		// Queued updates of a deleted view are discarded
+		CountingView * pView = new CountingView();
+		pView->setExecutor(&queue);
+		CIntParameter model("m", 0, 0, 1000);
+		pView->registerAt(&model);
+		model.assignValue(7);
+		pView->unregisterAt(&model);
+		delete pView;
+		CHECK(queue.runPending() == 1);
+	}
+	// The executor thread drains while the views are created and deleted
+	std::atomic<bool> running(true);
+	std::thread owner([&]() {
+		while (running) {
+			queue.wait(std::chrono::milliseconds(1));
+			queue.runPending();
+			}
+		queue.runPending();
+		});
+	CIntParameter model("m", 0, 0, 1000000);
+	for (int i = 0; i < 2000; i++) {
+		CountingView * pView = new CountingView();
+		pView->setExecutor(&queue);
+		pView->registerAt(&model);
+		model.assignValue(i + 1);
+		std::this_thread::yield();
+		pView->unregisterAt(&model);
+		delete pView;
+		}
+	running = false;
+	owner.join();
+}
+
+// -------------------------------------------------------
+static void testGracePeriod(bool parallel) {
+	CIntParameter model("m", 0, 0, 100000000);
+	ReregisteringView self(&model);
+	if (parallel)
+		model.setParallelFanOut(2);
+	std::atomic<bool> running(true);
+	std::thread writer([&]() {
+		int i = 0;
+		while (running)
+			model.assignValue(++i % 100000000);
+		});
+	int violations = 0;
+	for (int round = 0; round < 100; round++) {
+		UnregisteredView * pView = new UnregisteredView();
+		pView->registerAt(&model);
+		std::this_thread::sleep_for(std::chrono::microseconds(300));
+		pView->unregisterAt(&model);
+		pView->m_Unregistered = true;
+		std::this_thread::sleep_for(std::chrono::microseconds(300));
+		violations += pView->m_Violations;
+		delete pView;
+		}
+	running = false;
+	writer.join();
+	self.unregisterAt(&model);
+	CHECK(violations == 0);
+}
+
+// -------------------------------------------------------
+static void testDestroyedWhileNotifying() {
+	CIntParameter model("m", 0, 0, 100000000);
+	model.setSyncMode(false);
+	std::atomic<bool> running(true);
+	std::thread writer([&]() {
+		int i = 0;
+		while (running) {
+			model.assignValue(++i % 100000000);
+			std::this_thread::yield();
+			}
+		});
+	std::atomic<int> violations(0);
+	for (int round = 0; round < 200; round++) {
+		// A typed view, updated by the Dispatcher
+		DestroyedTView * pView = new DestroyedTView(&model, &violations);
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+		delete pView;
+		// A subscription whose callback refers to a heap object
+		std::atomic<long> * pCalls = new std::atomic<long>(0);
+		unsigned int id = model.subscribe([pCalls](const int &, const int &) { (*pCalls)++; });
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+		model.unsubscribe(id);
+		delete pCalls;
+		}
+	running = false;
+	writer.join();
+	CHECK(violations == 0);
+}
+
+// -------------------------------------------------------
+int main() {
+	testDeletedModels();
+	testExecutorViews();
+	testGracePeriod(false);
+	testGracePeriod(true);
+	testDestroyedWhileNotifying();
+	return CHECK_RESULT("TestLifetime");
+}
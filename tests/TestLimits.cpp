@@ -0,0 +1,136 @@
+/**
+ * Limits test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The limits of a TNumParameter are read under a shared lock: readers stepping
+ * the value while a writer assigns values and exchanges the TNumLimits, and the
+ * recursion rules of sync::CSharedMutex.
+ */
+
+#include "Check.h"
+#include "../model/NumLimits.h"
+#include "../model/Parameter.h"
+#include "../sync/Synchronized.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+class FixedLimits : public TNumLimits<int> {
+public:
+	FixedLimits(int minValue, int maxValue) : m_Min(minValue), m_Max(maxValue) {}
+	virtual int getMinValue(TNumParameter<int> *) override { return m_Min; }
+	virtual int getMaxValue(TNumParameter<int> *) override { return m_Max; }
+	const int m_Min;
+	const int m_Max;
+};
+
+// -------------------------------------------------------
+static void testSharedMutex() {
+	sync::CSharedMutex mutex;
+	int sum = 0;
+	synchronized_exclusive(mutex) {
+		synchronized_shared(mutex) {     // Within the own exclusive lock
+			synchronized_exclusive(mutex) {
+				sum++;
+				}
+			}
+		}
+	synchronized_shared(mutex) {
+		synchronized_shared(mutex) {     // Nested shared locks are counted
+			sum++;
+			}
+		bool thrown = false;
+		try {
+			mutex.lock();
+			mutex.unlock();
+			}
+		catch (const std::logic_error &) {
+			thrown = true;
+			}
+		CHECK(thrown);                   // A shared lock cannot be upgraded
+		}
+	CHECK(sum == 2);
+	CHECK(mutex.try_lock());             // Released by all the lockers above
+	mutex.unlock();
+}
+
+// -------------------------------------------------------
+// Several readers step the value while a writer assigns and exchanges the limits
+static void testReadersAndWriter() {
+	CIntParameter gain("gain", 0, -100, 100, 5);
+	FixedLimits narrow(-10, 10), wide(-50, 50);
+	std::atomic<bool> running(true);
+	std::atomic<long> wrong(0), reads(0);
+	std::vector<std::thread> readers;
+	for (int t = 0; t < 4; t++) {
+		readers.emplace_back([&]() {
+			while (running) {
+				const int minValue = gain.getMinValue();
+				const int maxValue = gain.getMaxValue();
+				const int next     = gain.getNextValue();
+				const int prev     = gain.getPrevValueRotated();
+				// Any of the three limits
+				if (!(minValue == -100 || minValue == -10 || minValue == -50) || !(maxValue == 100 || maxValue == 10 || maxValue == 50))
+					wrong++;
+				if (next < -100 || next > 100 || prev < -100 || prev > 100)
+					wrong++;
+				reads++;
+				}
+			});
+		}
+	while (reads == 0)
+		std::this_thread::yield();
+	for (int i = 0; i < 20000; i++) {
+		gain.assignValue(i % 200 - 100);
+		if (i % 100 == 0) {
+			std::this_thread::yield();
+			gain.setNumLimits((i / 100) % 3 == 0 ? nullptr : (i / 100) % 3 == 1 ? static_cast<TNumLimits<int> *>(&narrow) : &wide);
+			}
+		}
+	gain.setNumLimits(&narrow);
+	gain.assignValue(70);
+	CHECK(gain.getValue() == 10);
+	CHECK(gain.getNextValue() == 10);
+	CHECK(gain.getNextValueRotated() == -10);
+	CHECK(gain.getPrevValue() == 5);
+	running = false;
+	for (std::thread & reader : readers)
+		reader.join();
+	CHECK(wrong == 0);
+	gain.setNumLimits(nullptr);
+}
+
+// -------------------------------------------------------
+int main() {
+	testSharedMutex();
+	testReadersAndWriter();
+	return CHECK_RESULT("TestLimits");
+}
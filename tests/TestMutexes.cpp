@@ -0,0 +1,100 @@
+/**
+ * Mutex test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Mutual exclusion of the mutex classes: exact counts of threads incrementing
+ * under synchronized(), try_lock() while another thread holds the mutex, and
+ * waiters of long critical sections which park and are woken up.
+ */
+
+#include "Check.h"
+#include "../sync/Mutexes.h"
+#include "../sync/Synchronized.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+
+// -------------------------------------------------------
+// Threads increment a counter under the mutex, optionally holding it for a while
+template <class M> static long count(int threadCount, long increments, std::chrono::microseconds hold) {
+	M mutex;
+	long counter = 0;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; t++) {
+		threads.emplace_back([&]() {
+			for (long i = 0; i < increments; i++) {
+				synchronized(mutex) {
+					const long value = counter;
+					if (hold.count() > 0)
+						std::this_thread::sleep_for(hold);
+					counter = value + 1;
+					}
+				}
+			});
+		}
+	for (std::thread & thread : threads)
+		thread.join();
+	return counter;
+}
+
+// -------------------------------------------------------
+// try_lock() fails while another thread holds the mutex
+template <class M> static void testTryLock() {
+	M mutex;
+	CHECK(mutex.try_lock());
+	bool locked = true;
+	std::thread other([&]() { locked = mutex.try_lock(); });
+	other.join();
+	CHECK(!locked);
+	mutex.unlock();
+	std::thread again([&]() {
+		locked = mutex.try_lock();
+		if (locked)
+			mutex.unlock();
+		});
+	again.join();
+	CHECK(locked);
+}
+
+// -------------------------------------------------------
+template <class M> static void testMutex() {
+	CHECK(count<M>(4, 100000, std::chrono::microseconds(0)) == 400000);
+	// Longer than the spinning of CAdaptiveMutex, the waiters park
+	CHECK(count<M>(4, 50, std::chrono::microseconds(200)) == 200);
+	testTryLock<M>();
+}
+
+// -------------------------------------------------------
+int main() {
+	testMutex<sync::CPlainMutex>();
+	testMutex<sync::CSpinMutex>();
+	testMutex<sync::CAdaptiveMutex>();
+	testMutex<sync::CMutex>();
+	return CHECK_RESULT("TestMutexes");
+}
@@ -0,0 +1,105 @@
+/**
+ * Overflow test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A bounded notification queue with the BLOCK policy: views assigning models
+ * from the Dispatcher or the FanOutPool must not block, and the program must
+ * exit cleanly with notifications still queued.
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../mvc/View.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+// Forwards every update to another model
+class ForwardingView : public mvc::View {
+public:
+	explicit ForwardingView(CIntParameter * pTarget = nullptr) : m_pTarget(pTarget), m_Updates(0) {}
+	virtual void update(const mvc::Model *, void *) override {
+		m_pTarget->assignValue(m_pTarget->getValue() + 1);
+		m_Updates++;
+	}
+	CIntParameter *   m_pTarget;
+	std::atomic<long> m_Updates;
+};
+
+// Notified by the Dispatcher at exit, see main()
+static CountingView s_View(std::chrono::microseconds(50));
+
+// -------------------------------------------------------
+static void testBlockingViews() {
+	mvc::Model::setNotificationQueue(1, mvc::Model::BLOCK);
+	CIntParameter x("x", 0, 0, 1000000), y("y", 0, 0, 1000000);
+	x.setSyncMode(false);
+	y.setSyncMode(false);
+	x.setParallelFanOut(2);
+	std::vector<ForwardingView> views(8);
+	for (ForwardingView & view : views) {
+		view.m_pTarget = &y;
+		view.registerAt(&x);
+		}
+	CountingView counter(std::chrono::microseconds(50));
+	counter.registerAt(&y);
+	for (int i = 1; i <= 200; i++)
+		x.assignValue(i);
+	// Deadlocks if the views assigning y block on the full queue
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	long updates = 0;
+	while (updates < 200L * 8 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		updates = 0;
+		for (const ForwardingView & view : views)
+			updates += view.m_Updates;
+		}
+	CHECK(updates == 200L * 8);
+	for (ForwardingView & view : views)
+		view.unregisterAt(&x);
+	counter.unregisterAt(&y);
+}
+
+// -------------------------------------------------------
+int main() {
+	testBlockingViews();
+	const int result = CHECK_RESULT("TestOverflow");
+
+	// Exit with queued notifications of models which are never deleted
+	mvc::Model::setNotificationQueue(16, mvc::Model::BLOCK);
+	CIntParameter * pModels = new CIntParameter[8];
+	for (int k = 0; k < 8; k++) {
+		pModels[k].setSyncMode(false);
+		s_View.registerAt(&pModels[k]);
+		}
+	for (int i = 1; i <= 2000; i++)
+		pModels[i % 8].assignValue(i % 1000);
+	return result;
+}
@@ -0,0 +1,157 @@
+/**
+ * Profiler test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Checks the statistics of the lock profiler: the histogram buckets and
+ * percentiles, merging and resetting of lock statistics, exact counts under
+ * concurrent recording and the per-name statistics shared by the mutexes.
+ * The profiled locks themselves are only checked if DE_BSWALZ_SYNC_PROFILING
+ * is defined.
+ */
+
+#include "Check.h"
+#include "../sync/Profiler.h"
+#include "../sync/Synchronized.h"
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using sync::Profiler;
+
+// -------------------------------------------------------
+static void testHistogram() {
+	Profiler::Histogram histogram;
+	CHECK(histogram.getCount() == 0);
+	CHECK(histogram.getPercentile(0.5) == 0);
+	histogram.add(0);                               // Bucket 0
+	histogram.add(1);                               // Bucket 0
+	histogram.add(5);                               // Bucket 2: [4, 8)
+	histogram.add(1000);                            // Bucket 9: [512, 1024)
+	CHECK(histogram.getCount() == 4);
+	CHECK(histogram.getTotal() == 1006);
+	CHECK(histogram.getMax() == 1000);
+	CHECK(histogram.getPercentile(0.0) == 1);
+	CHECK(histogram.getPercentile(0.5) == 7);
+	CHECK(histogram.getPercentile(0.99) == 1000);  // Upper bound limited by the maximum
+
+	Profiler::Histogram other;
+	other.add(3);
+	other.add(2000);
+	histogram.add(other);
+	CHECK(histogram.getCount() == 6);
+	CHECK(histogram.getTotal() == 3009);
+	CHECK(histogram.getMax() == 2000);
+
+	histogram.reset();
+	CHECK(histogram.getCount() == 0);
+	CHECK(histogram.getTotal() == 0);
+	CHECK(histogram.getMax() == 0);
+}
+
+// -------------------------------------------------------
+static void testLockStats() {
+	Profiler::LockStats stats;
+	stats.add(false, 0, 10);
+	stats.add(true, 100, 20);
+	stats.add(true, 300, 30);
+	CHECK(stats.m_Acquisitions.load() == 3);
+	CHECK(stats.m_Contended.load() == 2);
+	CHECK(stats.m_Wait.getCount() == 2);            // Only contended acquisitions wait
+	CHECK(stats.m_Wait.getTotal() == 400);
+	CHECK(stats.m_Hold.getCount() == 3);
+	CHECK(stats.m_Hold.getTotal() == 60);
+
+	Profiler::LockStats merged;
+	merged.add(false, 0, 5);
+	merged.add(stats);
+	CHECK(merged.m_Acquisitions.load() == 4);
+	CHECK(merged.m_Contended.load() == 2);
+	CHECK(merged.m_Wait.getMax() == 300);
+	CHECK(merged.m_Hold.getTotal() == 65);
+
+	merged.reset();
+	CHECK(merged.m_Acquisitions.load() == 0);
+	CHECK(merged.m_Contended.load() == 0);
+	CHECK(merged.m_Wait.getCount() == 0);
+	CHECK(merged.m_Hold.getCount() == 0);
+}
+
+// -------------------------------------------------------
+static void testConcurrentRecording() {
+	const int threads = 4, n = 100000;
+	Profiler::LockStats stats;
+	std::vector<std::thread> recorders;
+	for (int t = 0; t < threads; t++) {
+		recorders.emplace_back([&stats, t]() {
+			for (int i = 0; i < n; i++)
+				stats.add(i % 2 == 0, uint64_t(t), uint64_t(i));
+			});
+		}
+	for (std::thread & recorder : recorders)
+		recorder.join();
+	CHECK(stats.m_Acquisitions.load() == uint64_t(threads) * n);
+	CHECK(stats.m_Contended.load() == uint64_t(threads) * n / 2);
+	CHECK(stats.m_Wait.getTotal() == uint64_t(n / 2) * (0 + 1 + 2 + 3));
+	CHECK(stats.m_Hold.getCount() == uint64_t(threads) * n);
+	CHECK(stats.m_Hold.getMax() == uint64_t(n - 1));
+}
+
+// -------------------------------------------------------
+static void testMutexStats() {
+	Profiler * pProfiler = Profiler::getInstance();
+	CHECK(pProfiler == Profiler::getInstance());
+	Profiler::LockStats * pStats = pProfiler->getMutexStats("test.profiler");
+	CHECK(pStats != nullptr);
+	CHECK(pProfiler->getMutexStats("test.profiler") == pStats);
+	CHECK(pProfiler->getMutexStats("test.other") != pStats);
+
+	pStats->add(true, 50, 50);
+	pProfiler->reset();
+	CHECK(pStats->m_Acquisitions.load() == 0);
+
+	sync::CMutex mutex;
+	mutex.setName("test.profiler");
+	CHECK((getLockStats(mutex) == pStats) == Profiler::isEnabled());
+	for (int i = 0; i < 10; i++) {
+		synchronized(mutex) {
+			}
+		}
+	CHECK(pStats->m_Acquisitions.load() == (Profiler::isEnabled() ? 10u : 0u));
+
+	std::ostringstream os;
+	pProfiler->dump(os, 10);
+	CHECK(os.str().find(Profiler::isEnabled() ? "test.profiler" : "DE_BSWALZ_SYNC_PROFILING") != std::string::npos);
+}
+
+// -------------------------------------------------------
+int main() {
+	testHistogram();
+	testLockStats();
+	testConcurrentRecording();
+	testMutexStats();
+	return CHECK_RESULT("TestProfiler");
+}
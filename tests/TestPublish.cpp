@@ -0,0 +1,203 @@
+/**
+ * Publication test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * load() returns validated values only and never a torn value, and models of
+ * a type without default constructor support subscriptions. Run by a thread
+ * sanitizer, the seqlock and setDefaultValue() are free of data races.
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../sync/SeqLock.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+// Rejects odd values
+class EvenVoter : public mvc::TVoter<int> {
+public:
+	explicit EvenVoter(CIntParameter * pModel) : m_pModel(pModel) {}
+	virtual bool vote() override { return (m_pModel->getValue() & 1) == 0; }
+private:
+	CIntParameter * m_pModel;
+};
+
+struct Point {
+	Point() : m_X(0), m_Y(1) {}
+	Point(int x, int y) : m_X(x), m_Y(y) {}
+	bool operator!=(const Point & r) const { return m_X != r.m_X || m_Y != r.m_Y; }
+	int m_X;
+	int m_Y;
+};
+
+// A type without default constructor
+struct Level {
+	explicit Level(int value) : m_Value(value) {}
+	bool operator!=(const Level & r) const { return m_Value != r.m_Value; }
+	bool operator==(const Level & r) const { return m_Value == r.m_Value; }
+	int m_Value;
+};
+
+class LevelModel : public mvc::TModel<Level> {
+public:
+	LevelModel() : mvc::TModel<Level>("level", Level(0)) {}
+	virtual ~LevelModel() { cancelNotifications(); }
+};
+
+// -------------------------------------------------------
+static void testLoad() {
+	CIntParameter parameter("p", 0, 0, 1000000);
+	parameter.setVoter(std::make_shared<EvenVoter>(&parameter));
+	mvc::TModel<Point> point("point", Point(1, 2));
+	std::atomic<bool> running(true);
+	std::atomic<int> invalid(0);
+	std::thread reader([&]() {
+		while (running) {
+			if (parameter.load() & 1)
+				invalid++;
+			const Point value = point.load();
+			if (value.m_Y != value.m_X + 1)
+				invalid++;
+			}
+		});
+	std::thread subscriber([&]() {
+		while (running)
+			parameter.unsubscribe(parameter.subscribe([](const int &, const int &) {}));
+		});
+	int rejected = 0;
+	for (int i = 1; i < 100000; i++) {
+		if (!parameter.assignValue(i))
+			rejected++;
+		point.assignValue(Point(i, i + 1));
+		}
+	running = false;
+	reader.join();
+	subscriber.join();
+	CHECK(invalid == 0);
+	CHECK(rejected == 50000);
+	CHECK(parameter.load() == 99998);
+	parameter.setDefaultValue();
+	CHECK(parameter.load() == 0);
+	sync::TSeqLock<Level> level(Level(7));
+	CHECK(level.load().m_Value == 7);
+}
+
+// -------------------------------------------------------
+// Not a multiple of the word size, all bytes equal
+struct Bytes {
+	unsigned char m_Bytes[13];
+};
+
+// Two writers and a reader of a seqlock spanning several words
+static void testSeqLock() {
+	Bytes initial;
+	std::memset(initial.m_Bytes, 0, sizeof(initial.m_Bytes));
+	sync::TSeqLock<Bytes> bytes(initial);
+	std::atomic<bool> running(true);
+	std::atomic<int> torn(0);
+	std::thread reader([&]() {
+		while (running) {
+			const Bytes value = bytes.load();
+			for (size_t i = 1; i < sizeof(value.m_Bytes); i++) {
+				if (value.m_Bytes[i] != value.m_Bytes[0])
+					torn++;
+				}
+			}
+		});
+	std::thread writer([&]() {
+		Bytes value;
+		for (int i = 0; i < 100000; i++) {
+			std::memset(value.m_Bytes, 2 * (i % 100), sizeof(value.m_Bytes));
+			bytes.store(value);
+			}
+		});
+	Bytes value;
+	for (int i = 0; i < 100000; i++) {
+		std::memset(value.m_Bytes, 2 * (i % 100) + 1, sizeof(value.m_Bytes));
+		bytes.store(value);
+		}
+	writer.join();
+	running = false;
+	reader.join();
+	CHECK(torn == 0);
+}
+
+// -------------------------------------------------------
+// setDefaultValue() races with assignments and subscriptions
+static void testDefaultValue() {
+	CBoolParameter enabled("enabled", false);
+	std::atomic<bool> running(true);
+	std::thread subscriber([&]() {
+		while (running)
+			enabled.unsubscribe(enabled.subscribe([](const bool &, const bool &) {}));
+		});
+	std::thread resetter([&]() {
+		for (int i = 0; i < 10000; i++)
+			enabled.setDefaultValue();
+		});
+	for (int i = 0; i < 10000; i++)
+		enabled.assignValue(true);
+	resetter.join();
+	running = false;
+	subscriber.join();
+	enabled.setDefaultValue();
+	CHECK(enabled.load() == false);
+	CHECK(enabled.isDefaultValue());
+}
+
+// -------------------------------------------------------
+static void testSubscriptions() {
+	LevelModel model;
+	long plain = 0;
+	long filtered[40] = { 0 };
+	int lastOld[40] = { 0 };
+	model.subscribe([&](const Level &, const Level &) { plain++; }, true);
+	for (int i = 0; i < 40; i++) {
+		model.subscribeFiltered([&, i](const Level &, const Level & oldValue) { filtered[i]++; lastOld[i] = oldValue.m_Value; },
+			[i](const Level & value, const Level & last) { return i < 10 || value.m_Value - last.m_Value >= 10; });
+		}
+	for (int k = 1; k <= 9; k++)
+		model.assignValue(Level(k));
+	model.assignValue(Level(20));                    // Accepted by all 40 filters
+	CHECK(plain == 11);
+	CHECK(filtered[0] == 10 && lastOld[0] == 9);
+	CHECK(filtered[39] == 1 && lastOld[39] == 0);
+}
+
+// -------------------------------------------------------
+int main() {
+	testLoad();
+	testSeqLock();
+	testDefaultValue();
+	testSubscriptions();
+	return CHECK_RESULT("TestPublish");
+}
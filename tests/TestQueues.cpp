@@ -0,0 +1,113 @@
+/**
+ * Queue test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * close() of a TMpscQueue racing with pushes: every element is either rejected
+ * or popped by the consumer, none is lost.
+ */
+
+#include "Check.h"
+#include "../sync/Queues.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+
+// -------------------------------------------------------
+static void testClose() {
+	sync::TMpscQueue<int> queue(8);
+	CHECK(queue.push(1));
+	CHECK(queue.tryPush(2));
+	int values[2] = { 3, 4 };
+	CHECK(queue.tryPush(values, 2) == 2);
+	queue.close();
+	CHECK(queue.isClosed());
+	CHECK(!queue.tryPush(5));
+	CHECK(queue.tryPush(values, 2) == 0);
+	CHECK(!queue.push(6));
+	CHECK(queue.size() == 4);
+	int popped[8];
+	CHECK(queue.pop(popped, 8) == 4);
+	CHECK(popped[0] == 1 && popped[3] == 4);
+	CHECK(queue.pop(popped, 8) == 0);       // Closed and drained, does not wait
+}
+
+// -------------------------------------------------------
+// Producers push single elements and batches until the queue is closed
+static void testCloseRacingPush() {
+	for (int round = 0; round < 200; round++) {
+		sync::TMpscQueue<long> queue(16);
+		std::atomic<long> accepted(0), consumed(0);
+		std::vector<std::thread> producers;
+		for (int t = 0; t < 3; t++) {
+			producers.emplace_back([&queue, &accepted, t]() {
+				long values[4] = { 1, 1, 1, 1 };
+				for (long i = 0; ; i++) {
+					if (t == 0) {
+						if (!queue.push(1))
+							break;
+						accepted++;
+						}
+					else if (t == 1) {
+						if (queue.tryPush(1))
+							accepted++;
+						else if (queue.isClosed())
+							break;
+						}
+					else {
+						const size_t count = queue.tryPush(values, 4);
+						accepted += long(count);
+						if (count == 0 && queue.isClosed())
+							break;
+						}
+					if (i % 16 == 0)
+						std::this_thread::yield();
+					}
+				});
+			}
+		std::thread consumer([&]() {
+			long values[8];
+			while (size_t count = queue.pop(values, 8))
+				consumed += long(count);
+			});
+		for (int i = 0; i < round % 20; i++)
+			std::this_thread::yield();
+		queue.close();
+		for (std::thread & producer : producers)
+			producer.join();
+		consumer.join();
+		CHECK(consumed == accepted);
+		CHECK(queue.size() == 0);
+		}
+}
+
+// -------------------------------------------------------
+int main() {
+	testClose();
+	testCloseRacingPush();
+	return CHECK_RESULT("TestQueues");
+}
@@ -0,0 +1,228 @@
+/**
+ * Registry test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Tests the Registry: names, handles, prefix subscriptions delivered directly and
+ * by an executor, and views unsubscribed and deleted while models notify them.
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../mvc/Executor.h"
+#include "../mvc/Registry.h"
+#include "../mvc/View.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+static void testNames() {
+	mvc::Registry * pRegistry = mvc::Registry::getInstance();
+	const size_t size = pRegistry->size();
+	CIntParameter gain("names.gain", 0, 0, 100);
+	mvc::Registry::Handle handle = pRegistry->add(&gain);
+	CHECK(handle.isValid());
+	CHECK(pRegistry->add(&gain) == handle);
+	CHECK(pRegistry->size() == size + 1);
+	CHECK(pRegistry->find("names.gain") == &gain);
+	CHECK(pRegistry->find("names") == nullptr);
+	CHECK(pRegistry->resolve("names.gain") == handle);
+	CHECK(!pRegistry->resolve("names.balance").isValid());
+
+	// Another model with the same name
+	CIntParameter other("names.gain", 0, 0, 100);
+	bool thrown = false;
+	try {
+		pRegistry->add(&other);
+		}
+	catch (const std::logic_error &) {
+		thrown = true;
+		}
+	CHECK(thrown);
+	CHECK(pRegistry->find("names.gain") == &gain);
+
+	pRegistry->remove(&gain);
+	CHECK(pRegistry->find("names.gain") == nullptr);
+	CHECK(pRegistry->size() == size);
+}
+
+// -------------------------------------------------------
+static void testHandles() {
+	mvc::Registry * pRegistry = mvc::Registry::getInstance();
+	mvc::Registry::Handle stale;
+	{
+		CIntParameter gain("handles.gain", 0, 0, 100);
+		stale = pRegistry->add(&gain);
+		CHECK(pRegistry->get(stale) == &gain);
+	}
+	// Removed by the destructor, the reused slot is not reached by the old handle
+	CHECK(pRegistry->get(stale) == nullptr);
+	CIntParameter gain("handles.gain", 0, 0, 100), balance("handles.balance", 0, 0, 100);
+	pRegistry->add(&gain);
+	pRegistry->add(&balance);
+	CHECK(pRegistry->get(stale) == nullptr);
+	CHECK(pRegistry->get(mvc::Registry::Handle()) == nullptr);
+
+	std::vector<std::string> names = { "handles.balance", "handles.unknown", "handles.gain" };
+	std::vector<mvc::Registry::Handle> handles;
+	CHECK(pRegistry->resolve(names, handles) == 2);
+	std::vector<mvc::Model *> models;
+	pRegistry->get(handles, models);
+	CHECK(models.size() == 3);
+	CHECK(models[0] == &balance);
+	CHECK(models[1] == nullptr);
+	CHECK(models[2] == &gain);
+}
+
+// -------------------------------------------------------
+// Readers resolve handles without a lock while the slots are reused
+static void testConcurrentHandles() {
+	mvc::Registry * pRegistry = mvc::Registry::getInstance();
+	mvc::Registry::Handle stale;
+	{
+		CIntParameter gain("concurrent.gain", 0, 0, 100);
+		stale = pRegistry->add(&gain);
+	}
+	CIntParameter live("concurrent.live", 0, 0, 100);
+	const mvc::Registry::Handle handle = pRegistry->add(&live);
+	std::atomic<bool> running(true);
+	std::atomic<long> wrong(0);
+	std::vector<std::thread> readers;
+	for (int t = 0; t < 4; t++) {
+		readers.emplace_back([&]() {
+			while (running) {
+				if (pRegistry->get(stale) != nullptr || pRegistry->get(handle) != &live)
+					wrong++;
+				}
+			});
+		}
+	for (int i = 0; i < 20000; i++) {
+		// Reuses the slot of the stale handle with a new generation
+		CIntParameter model("concurrent.model", 0, 0, 100);
+		pRegistry->add(&model);
+		}
+	running = false;
+	for (std::thread & reader : readers)
+		reader.join();
+	CHECK(wrong == 0);
+	CHECK(pRegistry->get(handle) == &live);
+}
+
+// -------------------------------------------------------
+static void testPrefix() {
+	mvc::Registry * pRegistry = mvc::Registry::getInstance();
+	CIntParameter gain("prefix.mixer.ch1.gain", 0, 0, 100), mixers("prefix.mixers.gain", 0, 0, 100), mixer("prefix.mixer", 0, 0, 100);
+	pRegistry->add(&gain);
+	pRegistry->add(&mixers);
+	pRegistry->add(&mixer);
+	CountingView view, all;
+	pRegistry->subscribe("prefix.mixer", &view);
+	pRegistry->subscribe("prefix.mixer", &view);     // Subscribed once
+	pRegistry->subscribe("", &all);
+	CHECK(mvc::Registry::hasSubscriptions());
+	gain.assignValue(1);
+	mixers.assignValue(1);
+	mixer.assignValue(1);
+	CHECK(view.m_Updates == 2);
+	CHECK(all.m_Updates == 3);
+
+	// Unknown prefixes and views are ignored
+	pRegistry->unsubscribe("prefix.unknown.node", &view);
+	pRegistry->unsubscribe("prefix.mixers", &view);
+	gain.assignValue(2);
+	CHECK(view.m_Updates == 3);
+
+	pRegistry->unsubscribe("prefix.mixer", &view);
+	pRegistry->unsubscribe("", &all);
+	gain.assignValue(3);
+	CHECK(view.m_Updates == 3);
+	CHECK(all.m_Updates == 4);
+}
+
+// -------------------------------------------------------
+// Views are unsubscribed and deleted while the Dispatcher notifies them
+static void testUnsubscribeWhileNotifying() {
+	mvc::Registry * pRegistry = mvc::Registry::getInstance();
+	CIntParameter gain("notifying.gain", 0, 0, 1000000);
+	gain.setSyncMode(false);
+	pRegistry->add(&gain);
+	std::atomic<bool> running(true);
+	std::thread writer([&]() {
+		for (int i = 1; running; i++)
+			gain.assignValue(i % 1000000);
+		});
+	for (int i = 0; i < 2000; i++) {
+		CountingView * pView = new CountingView();
+		pRegistry->subscribe("notifying", pView);
+		std::this_thread::yield();
+		pRegistry->unsubscribe("notifying", pView);
+		delete pView;
+		}
+	running = false;
+	writer.join();
+}
+
+// -------------------------------------------------------
+static void testPrefixExecutor() {
+	mvc::Registry * pRegistry = mvc::Registry::getInstance();
+	CIntParameter gain("executor.mixer.gain", 0, 0, 1000);
+	pRegistry->add(&gain);
+	mvc::ExecutorQueue queue;
+	CountingView direct, queued;
+	queued.setExecutor(&queue);
+	pRegistry->subscribe("executor.mixer", &direct);
+	pRegistry->subscribe("executor.mixer", &queued);
+	for (int i = 1; i <= 10; i++)
+		gain.assignValue(i);
+	CHECK(direct.m_Updates == 10);
+	CHECK(queued.m_Updates == 0);
+	queue.runPending();
+	CHECK(queued.m_Updates == 10);
+
+	// Updates queued before the unsubscription are discarded
+	gain.assignValue(11);
+	pRegistry->unsubscribe("executor.mixer", &queued);
+	queue.runPending();
+	CHECK(queued.m_Updates == 10);
+	CHECK(direct.m_Updates == 11);
+	pRegistry->unsubscribe("executor.mixer", &direct);
+}
+
+// -------------------------------------------------------
+int main() {
+	testNames();
+	testHandles();
+	testConcurrentHandles();
+	testPrefix();
+	testUnsubscribeWhileNotifying();
+	testPrefixExecutor();
+	return CHECK_RESULT("TestRegistry");
+}
@@ -0,0 +1,130 @@
+/**
+ * Statistics test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Every update is counted in the histogram of its view while views register
+ * and unregister and the statistics are read concurrently, and every
+ * notification of concurrent notifiers is counted. Built with
+ * DE_BSWALZ_MVC_STATISTICS, see the Makefile.
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../mvc/Statistics.h"
+#include "../mvc/View.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+static void testNotifications() {
+	mvc::Statistics * pStatistics = mvc::Statistics::getInstance();
+	std::vector<std::unique_ptr<CIntParameter>> models;
+	for (int k = 0; k < 4; k++)
+		models.emplace_back(new CIntParameter("n" + std::to_string(k), 0, 0, 1000000));
+	std::vector<std::thread> notifiers;
+	for (int k = 0; k < 4; k++) {
+		CIntParameter * pModel = models[k].get();
+		notifiers.emplace_back([pModel, k]() {
+			for (int i = 1; i <= 1000 * (k + 1); i++)
+				pModel->assignValue(i);
+			});
+		}
+	for (std::thread & notifier : notifiers)
+		notifier.join();
+	const std::vector<mvc::Statistics::ModelRecord> records = pStatistics->getBusiestModels(4);
+	CHECK(records.size() == 4);
+	for (size_t i = 0; i < records.size(); i++) {
+		CHECK(records[i].m_pModel == models[3 - i].get());
+		CHECK(records[i].m_Notifications == 1000 * (4 - i));
+		}
+	models.clear();
+	CHECK(pStatistics->getBusiestModels(4).empty());
+}
+
+// -------------------------------------------------------
+static void testUpdates() {
+	mvc::Statistics * pStatistics = mvc::Statistics::getInstance();
+	CIntParameter model("m", 0, -100000000, 100000000);
+	model.setParallelFanOut(4);
+	std::vector<std::unique_ptr<CountingView>> views;
+	for (int i = 0; i < 16; i++) {
+		views.emplace_back(new CountingView());
+		views.back()->registerAt(&model);
+		}
+	std::atomic<bool> running(true);
+	std::thread churn([&]() {
+		while (running) {
+			CountingView view;
+			view.registerAt(&model);
+			std::this_thread::yield();
+			view.unregisterAt(&model);
+			}
+		});
+	std::thread reader([&]() {
+		while (running) {
+			pStatistics->getSlowestViews(5);
+			std::this_thread::yield();
+			}
+		});
+	for (int i = 1; i <= 3000; i++)
+		model.assignValue(i);
+	running = false;
+	churn.join();
+	reader.join();
+
+	const std::vector<mvc::Statistics::ViewRecord> records = pStatistics->getSlowestViews(100);
+	CHECK(records.size() == views.size());
+	uint64_t counted = 0;
+	for (const mvc::Statistics::ViewRecord & record : records)
+		counted += record.m_Duration.m_Count;
+	long updates = 0;
+	for (const auto & upView : views)
+		updates += upView->m_Updates;
+	CHECK(counted == uint64_t(updates));
+
+	// Reset clears the histograms, the views stay listed
+	pStatistics->reset();
+	model.assignValue(-1);
+	counted = 0;
+	for (const mvc::Statistics::ViewRecord & record : pStatistics->getSlowestViews(100))
+		counted += record.m_Duration.m_Count;
+	CHECK(counted == views.size());
+	for (const auto & upView : views)
+		upView->unregisterAt(&model);
+}
+
+// -------------------------------------------------------
+int main() {
+	testNotifications();
+	testUpdates();
+	return CHECK_RESULT("TestStatistics");
+}
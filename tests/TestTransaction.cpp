@@ -0,0 +1,203 @@
+/**
+ * Transaction test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Commit and rollback of transactions, assignments blocked by the transaction
+ * of another thread and the single notification of a fan-in of AssignRules.
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../mvc/Transaction.h"
+#include "../mvc/View.h"
+#include <memory>
+#include <thread>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+class SumVoter : public mvc::TVoter<int> {
+public:
+	SumVoter(CIntParameter * pA, CIntParameter * pB) : m_pA(pA), m_pB(pB) {}
+	virtual bool vote() override { return m_pA->getValue() + m_pB->getValue() <= 100; }
+private:
+	CIntParameter * m_pA;
+	CIntParameter * m_pB;
+};
+
+class AddRule : public mvc::TAssignRule<int> {
+public:
+	AddRule(CIntParameter * pTarget, int offset) : m_pTarget(pTarget), m_Offset(offset), m_Applied(0) { addTarget(pTarget); }
+	virtual void apply(mvc::TModel<int> * pSource) override { m_Applied++; m_pTarget->assignValue(pSource->getValue() + m_Offset, this); }
+	virtual void revert() override { m_pTarget->revertAssignment(); }
+	CIntParameter * m_pTarget;
+	int             m_Offset;
+	int             m_Applied;
+};
+
+// -------------------------------------------------------
+static void testCommitAndRollback() {
+	CIntParameter a("a", 10, 0, 1000), b("b", 20, 0, 1000), c("c", 0, 0, 10000);
+	CountingView view;
+	view.registerAt(&a);
+	view.registerAt(&b);
+	view.registerAt(&c);
+	auto spVoter = std::make_shared<SumVoter>(&a, &b);
+	a.setVoter(spVoter);
+	b.setVoter(spVoter);
+	AddRule rule(&c, 1000);
+	a.addAssignRule(&rule);
+
+	CHECK(!a.assignValue(90));                      // 90 + 20 > 100
+	CHECK(a.getValue() == 10);
+	view.m_Updates = 0;
+	rule.m_Applied = 0;
+	{
+		// Valid at commit only, the rule is applied and the views are notified once
+		mvc::Transaction transaction;
+		a.assignValue(90);
+		b.assignValue(5);
+		a.assignValue(80);
+		a.assignValue(90);
+		CHECK(rule.m_Applied == 0);
+		CHECK(view.m_Updates == 0);
+		CHECK(transaction.commit());
+	}
+	CHECK(a.getValue() == 90 && b.getValue() == 5 && c.getValue() == 1090);
+	CHECK(rule.m_Applied == 1);
+	CHECK(view.m_Updates == 3);
+	view.m_Updates = 0;
+	{
+		mvc::Transaction transaction;
+		a.assignValue(99);
+		b.assignValue(50);
+		CHECK(!transaction.commit());
+	}
+	CHECK(a.getValue() == 90 && b.getValue() == 5 && c.getValue() == 1090);
+	{
+		// Rolled back at the end of the scope
+		mvc::Transaction transaction;
+		a.assignValue(1);
+	}
+	CHECK(a.getValue() == 90);
+	CHECK(view.m_Updates == 0);
+	CHECK(a.assignValue(7));
+	CHECK(c.getValue() == 1007);
+	view.unregisterAt(&a);
+	view.unregisterAt(&b);
+	view.unregisterAt(&c);
+}
+
+// -------------------------------------------------------
+static void testOtherThread() {
+	CIntParameter a("a", 10, 0, 1000), b("b", 0, 0, 1000);
+	{
+		// A plain assignment of another thread is reported as failed
+		mvc::Transaction transaction;
+		a.assignValue(20);
+		bool other = true;
+		std::thread thread([&]() { other = a.assignValue(30); });
+		thread.join();
+		CHECK(!other);
+		CHECK(transaction.commit());
+	}
+	CHECK(a.getValue() == 20);
+	CHECK(a.assignValue(40));
+	{
+		// The transaction of another thread touching a is rolled back
+		mvc::Transaction transaction;
+		a.assignValue(50);
+		bool other = true;
+		std::thread thread([&]() {
+			mvc::Transaction otherTransaction;
+			b.assignValue(5);
+			a.assignValue(60);
+			other = otherTransaction.commit();
+			});
+		thread.join();
+		CHECK(!other);
+		CHECK(b.getValue() == 0);
+		CHECK(transaction.commit());
+	}
+	CHECK(a.getValue() == 50);
+}
+
+// -------------------------------------------------------
+static void testRollbackOfOtherThread() {
+	CIntParameter a("a", 0, 0, 1000), b("b", 0, 0, 1000);
+	AddRule ab(&b, 1);
+	a.addAssignRule(&ab);
+	{
+		mvc::Transaction transaction;
+		b.assignValue(7);
+		bool other = true;
+		std::thread thread([&]() {
+			// The AssignRule cannot assign b, the rollback must not revert b either
+			mvc::Transaction otherTransaction;
+			a.assignValue(5);
+			other = otherTransaction.commit();
+			});
+		thread.join();
+		CHECK(!other);
+		CHECK(a.getValue() == 0);
+		CHECK(b.getValue() == 7);
+		CHECK(transaction.commit());
+	}
+	CHECK(b.getValue() == 7);
+	CHECK(b.load() == 7);
+}
+
+// -------------------------------------------------------
+static void testFanIn() {
+	CIntParameter a("a", 0, -1000000, 1000000), b("b", 0, -1000000, 1000000);
+	CIntParameter c("c", 0, -1000000, 1000000), d("d", 0, -1000000, 1000000);
+	AddRule ab(&b, 1), bc(&c, 1), ad(&d, 1), dc(&c, 1);
+	a.addAssignRule(&ab);
+	b.addAssignRule(&bc);
+	a.addAssignRule(&ad);
+	d.addAssignRule(&dc);
+	CountingView view;
+	view.registerAt(&a);
+	view.registerAt(&b);
+	view.registerAt(&c);
+	// Diamond a -> b -> c and a -> d -> c: c is notified once with its final value
+	CHECK(a.assignValue(5000));
+	CHECK(view.m_Updates == 3);
+	CHECK(c.getValue() == 5002);
+	view.unregisterAt(&a);
+	view.unregisterAt(&b);
+	view.unregisterAt(&c);
+}
+
+// -------------------------------------------------------
+int main() {
+	testCommitAndRollback();
+	testOtherThread();
+	testRollbackOfOtherThread();
+	testFanIn();
+	return CHECK_RESULT("TestTransaction");
+}
@@ -0,0 +1,92 @@
+/**
+ * Voter test of MVC pattern
+ *
+ * @copyright	2005 Siegfried Walz
+ * @license     https://www.gnu.org/licenses/lgpl-3.0.txt GNU Lesser General Public License
+ * @author      Siegfried Walz
+ * @link        https://software.bswalz.de/
+ * @package     common/mvc
+ */
+/*
+ * This file is part of common/mvc
+ *
+ * common/mvc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * common/sync is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Memoization of the vote of a voter with declared dependencies, and voters
+ * locking other models while the assignments run in several threads.
+ */
+
+#include "Check.h"
+#include "../model/Parameter.h"
+#include "../sync/Synchronized.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using namespace de::bswalz;
+using namespace de::bswalz::model;
+
+// -------------------------------------------------------
+// Limits the sum of two models and reads b consistently: the assignment of b
+// holds the mutex of b while voting, the assignment of a does not.
+class SumVoter : public mvc::TVoter<int> {
+public:
+	SumVoter(CIntParameter * pA, CIntParameter * pB) : m_pA(pA), m_pB(pB), m_Votes(0) {
+		dependsOn(pA);
+		dependsOn(pB);
+	}
+	virtual bool vote() override {
+		m_Votes++;
+		std::this_thread::yield();
+		sync::CMutex & mutex = m_pB->getMutex();
+		bool result = false;
+		synchronized(mutex) {
+			result = m_pA->getValue() + m_pB->getValue() <= 1000;
+			}
+		return result;
+	}
+	CIntParameter *   m_pA;
+	CIntParameter *   m_pB;
+	std::atomic<long> m_Votes;
+};
+
+// -------------------------------------------------------
+int main() {
+	CIntParameter a("a", 0, 0, 1000), b("b", 0, 0, 1000);
+	auto spVoter = std::make_shared<SumVoter>(&a, &b);
+	a.setVoter(spVoter);
+	b.setVoter(spVoter);
+
+	// Would deadlock if vote() was called with locked voter
+	std::thread threadA([&]() { for (int i = 0; i < 2000; i++) a.assignValue(i % 400); });
+	std::thread threadB([&]() { for (int i = 0; i < 2000; i++) b.assignValue(i % 400); });
+	threadA.join();
+	threadB.join();
+
+	// Unchanged models: one vote at most
+	spVoter->m_Votes = 0;
+	CHECK(a.validateAssignment());
+	CHECK(a.validateAssignment());
+	CHECK(b.validateAssignment());
+	CHECK(spVoter->m_Votes <= 1);
+
+	// A modification invalidates the memo
+	CHECK(b.assignValue(500));
+	CHECK(!a.assignValue(900));
+	CHECK(a.getValue() != 900);
+	CHECK(a.assignValue(400));
+	return CHECK_RESULT("TestVoter");
+}